@@ -30,10 +30,42 @@ ControlUI::ControlUI(QWidget *parent) : QWidget(parent), isRecording(false), rec
     layout->setContentsMargins(10, 10, 10, 10);
     layout->setAlignment(Qt::AlignTop);
 
+    // Stream whose statistics are shown below, hidden for a single stream
+    streamComboBox = new QComboBox(this);
+    streamComboBox->setVisible(false);
+    connect(streamComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ControlUI::onStreamSelected);
+    layout->addWidget(streamComboBox);
+
     // FPS display
     fpsLabel = new QLabel("FPS: 0", this);
     layout->addWidget(fpsLabel);
 
+    // Receive batching statistics
+    receiveStatsLabel = new QLabel("Packets/syscall: -", this);
+    layout->addWidget(receiveStatsLabel);
+
+    // Packets dropped inside the application, separate from network loss
+    ringOverflowLabel = new QLabel("Ring overflow: 0 packets", this);
+    layout->addWidget(ringOverflowLabel);
+
+    // Packets the kernel dropped before the receiver could read them
+    socketOverflowLabel = new QLabel("Socket overflow: 0 packets", this);
+    layout->addWidget(socketOverflowLabel);
+
+    // Rows lost on the wire and filled in before display
+    concealmentLabel = new QLabel("Concealed: -", this);
+    layout->addWidget(concealmentLabel);
+
+    // Frames the recorder could not keep up with, separate from network loss
+    recorderStatsLabel = new QLabel("Recorder: idle", this);
+    layout->addWidget(recorderStatsLabel);
+
+    // Where packets and frames were lost, and how long each stage takes
+    lossLabel = new QLabel("Loss: -", this);
+    layout->addWidget(lossLabel);
+    latencyLabel = new QLabel("Latency: -", this);
+    layout->addWidget(latencyLabel);
+
     // Brightness slider
     QLabel *brightnessLabel = new QLabel("Brightness", this);
     brightnessValueLabel = new QLabel(QString::number(50), this);
@@ -133,6 +165,50 @@ void ControlUI::onFPSChanged(int fps) {
     fpsLabel->setText(QString("FPS: %1").arg(fps));
 }
 
+void ControlUI::onReceiveStatsChanged(double packetsPerSyscall, double batchOccupancy) {
+    receiveStatsLabel->setText(QString("Packets/syscall: %1 (batch fill %2%)")
+                               .arg(packetsPerSyscall, 0, 'f', 1)
+                               .arg(batchOccupancy * 100.0, 0, 'f', 0));
+}
+
+void ControlUI::onRingOverflowChanged(quint64 droppedPackets) {
+    ringOverflowLabel->setText(QString("Ring overflow: %1 packets").arg(droppedPackets));
+}
+
+void ControlUI::onSocketOverflowChanged(quint64 droppedPackets) {
+    socketOverflowLabel->setText(QString("Socket overflow: %1 packets").arg(droppedPackets));
+}
+
+void ControlUI::onConcealmentChanged(int frames, int interpolatedLines, int temporalLines) {
+    concealmentLabel->setText(QString("Concealed: %1 frames/s (%2 rows interpolated, %3 from previous)")
+                              .arg(frames).arg(interpolatedLines).arg(temporalLines));
+}
+
+void ControlUI::onRecorderStatsChanged(quint64 writtenFrames, quint64 droppedFrames) {
+    recorderStatsLabel->setText(QString("Recorder: %1 frames written, %2 dropped")
+                                .arg(writtenFrames).arg(droppedFrames));
+}
+
+void ControlUI::onMetricsUpdated(const MetricsSnapshot &snapshot) {
+    lossLabel->setText(QString("Loss: %1 late, %2 duplicate, %3 runt, %4 out of range lines\n"
+                               "Frames: %5 complete, %6 incomplete, %7 without buffer\n"
+                               "Display: %8 painted, %9 skipped")
+                       .arg(snapshot.lateLines).arg(snapshot.duplicateLines)
+                       .arg(snapshot.runtPackets).arg(snapshot.outOfRangeLines)
+                       .arg(snapshot.framesComplete).arg(snapshot.framesIncomplete)
+                       .arg(snapshot.framesNoBuffer)
+                       .arg(snapshot.framesPainted).arg(snapshot.framesSkipped));
+
+    // p50/p99 in milliseconds for each stage over the last interval
+    auto stage = [](const LatencySummary &summary) {
+        return QString("%1/%2").arg(summary.p50Us / 1000.0, 0, 'f', 2).arg(summary.p99Us / 1000.0, 0, 'f', 2);
+    };
+    latencyLabel->setText(QString("Latency p50/p99 ms: publish %1, paint %2, total %3")
+                          .arg(stage(snapshot.arrivalToPublish))
+                          .arg(stage(snapshot.publishToPaint))
+                          .arg(stage(snapshot.arrivalToPaint)));
+}
+
 void ControlUI::onBrightnessChanged(int value) {
     brightnessValueLabel->setText(QString::number(value));
     emit brightnessChanged(value);
@@ -161,7 +237,36 @@ void ControlUI::onTakeSnapshot() {
     emit snapshotRequested(saveDirectory);
 }
 
+void ControlUI::setStreamNames(const QStringList &names) {
+    streamComboBox->clear();
+    streamComboBox->addItems(names);
+    streamComboBox->setVisible(names.size() > 1);
+}
+
+int ControlUI::selectedStream() const {
+    return qMax(0, streamComboBox->currentIndex());
+}
+
+void ControlUI::onStreamSelected(int index) {
+    Q_UNUSED(index);
+
+    // The new stream's figures arrive within a second
+    fpsLabel->setText("FPS: 0");
+    receiveStatsLabel->setText("Packets/syscall: -");
+    ringOverflowLabel->setText("Ring overflow: 0 packets");
+    socketOverflowLabel->setText("Socket overflow: 0 packets");
+    concealmentLabel->setText("Concealed: -");
+    recorderStatsLabel->setText("Recorder: idle");
+    lossLabel->setText("Loss: -");
+    latencyLabel->setText("Latency: -");
+}
+
 void ControlUI::onRecordVideo() {
+    if (isRecording) {
+        emit recordingStopRequested();
+        return;
+    }
+
     if (saveDirectory.isEmpty()) {
         QMessageBox::warning(this, "Save Directory Not Set", "Please select a save directory before recording.");
         return;
@@ -173,7 +278,7 @@ void ControlUI::onRecordVideo() {
         return;
     }
 
-    // Emit signal to toggle recording state
+    // Emit signal to start recording
     emit recordingRequested(saveDirectory, format);
 }
 
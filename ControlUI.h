@@ -12,12 +12,20 @@
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QDebug>
+#include "PipelineMetrics.h"
 
 class ControlUI : public QWidget {
     Q_OBJECT
 public:
     explicit ControlUI(QWidget *parent = nullptr);
 
+    // Streams whose statistics can be shown; the selector appears only for
+    // more than one stream
+    void setStreamNames(const QStringList &names);
+
+    // Index of the stream whose statistics are shown
+    int selectedStream() const;
+
 signals:
     // Signal to request a snapshot
     void snapshotRequested(const QString &directory);
@@ -25,6 +33,9 @@ signals:
     // Signal to request video recording
     void recordingRequested(const QString &directory, const QString &format);
 
+    // Signal to stop the running recording
+    void recordingStopRequested();
+
     // Signal for horizontal image flipping
     void flipHorizontalRequested(bool enabled);
 
@@ -44,6 +55,24 @@ public slots:
     // FPS update
     void onFPSChanged(int fps);
 
+    // Receive batching statistics update
+    void onReceiveStatsChanged(double packetsPerSyscall, double batchOccupancy);
+
+    // Packet ring overflow update
+    void onRingOverflowChanged(quint64 droppedPackets);
+
+    // Kernel socket buffer overflow update
+    void onSocketOverflowChanged(quint64 droppedPackets);
+
+    // Missing-row concealment update
+    void onConcealmentChanged(int frames, int interpolatedLines, int temporalLines);
+
+    // Recorder queue update
+    void onRecorderStatsChanged(quint64 writtenFrames, quint64 droppedFrames);
+
+    // Loss counters and latency percentiles update
+    void onMetricsUpdated(const MetricsSnapshot &snapshot);
+
 private slots:
     // Brightness adjustment
     void onBrightnessChanged(int value);
@@ -72,9 +101,20 @@ private slots:
     // Toggle vertical flipping
     void onFlipVerticalChanged(bool checked);
 
+    // Clear the statistics of the previously selected stream
+    void onStreamSelected(int index);
+
 private:
     // UI elements
+    QComboBox *streamComboBox;         // Dropdown for selecting the stream whose statistics are shown
     QLabel *fpsLabel;                  // Label to display FPS
+    QLabel *receiveStatsLabel;         // Label to display receive batching statistics
+    QLabel *ringOverflowLabel;         // Label to display packets lost to a full packet ring
+    QLabel *socketOverflowLabel;       // Label to display packets the kernel dropped from a full socket buffer
+    QLabel *concealmentLabel;          // Label to display concealed rows per second
+    QLabel *recorderStatsLabel;        // Label to display frames written/dropped by the recorder
+    QLabel *lossLabel;                 // Label to display packet and frame loss counters
+    QLabel *latencyLabel;              // Label to display per-stage latency percentiles
     QSlider *brightnessSlider;         // Brightness slider
     QLabel *brightnessValueLabel;      // Label to display brightness value
     QSlider *gammaSlider;              // Gamma slider
@@ -0,0 +1,203 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: DetectionContext.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the DetectionContext class,
+the reusable pre- and post-processing state of a
+YOLO detector. Frames are letterboxed, normalised
+and split into planes in a single pass, and the
+network output is parsed in place with a vector
+threshold pass ahead of non-maximum suppression.
+===================================================
+*/
+
+#include "DetectionContext.h"
+#include "FramePool.h"
+#include <QDebug>
+#include <opencv2/dnn.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(Q_PROCESSOR_X86)
+#include <emmintrin.h>
+#endif
+
+namespace {
+// Letterbox padding, the grey YOLO models are trained with
+const float kPadValue = 114.0f / 255.0f;
+// Bilinear weights are 8-bit on each axis
+const float kNormalise = 1.0f / (255.0f * 256.0f * 256.0f);
+}
+
+DetectionContext::DetectionContext(int inputSize)
+    : inputSize(inputSize),
+      frameWidth(0),
+      frameHeight(0),
+      frameStride(0),
+      scale(1.0),
+      resizedWidth(0),
+      resizedHeight(0),
+      padX(0),
+      padY(0),
+      warnedShape(false) {
+    const int shape[] = { 1, 3, inputSize, inputSize };
+    blob.create(4, shape, CV_32F);
+}
+
+void DetectionContext::buildTaps(std::vector<Tap> &taps, int sourceSize, int targetSize, double scale, int step) {
+    taps.resize(targetSize);
+    for (int i = 0; i < targetSize; ++i) {
+        // Pixel centres line up, as with cv::resize(INTER_LINEAR)
+        double source = (i + 0.5) / scale - 0.5;
+        source = std::max(0.0, std::min(source, double(sourceSize - 1)));
+        const int first = static_cast<int>(source);
+        const int second = std::min(first + 1, sourceSize - 1);
+        taps[i].first = first * step;
+        taps[i].second = second * step;
+        taps[i].weight = static_cast<int>(std::lround((source - first) * 256.0));
+    }
+}
+
+void DetectionContext::rebuildGeometry(int width, int height, int stride) {
+    frameWidth = width;
+    frameHeight = height;
+    frameStride = stride;
+
+    scale = std::min(double(inputSize) / width, double(inputSize) / height);
+    resizedWidth = std::max(1, std::min(inputSize, static_cast<int>(std::lround(width * scale))));
+    resizedHeight = std::max(1, std::min(inputSize, static_cast<int>(std::lround(height * scale))));
+    padX = (inputSize - resizedWidth) / 2;
+    padY = (inputSize - resizedHeight) / 2;
+
+    buildTaps(columns, width, resizedWidth, scale, 3);
+    buildTaps(rows, height, resizedHeight, scale, stride);
+
+    // The padding never changes for this geometry, so it is written once here
+    blob.setTo(cv::Scalar(kPadValue));
+}
+
+const cv::Mat &DetectionContext::prepare(const FrameBuffer &frame) {
+    if (frame.width() != frameWidth || frame.height() != frameHeight || frame.bytesPerLine() != frameStride) {
+        rebuildGeometry(frame.width(), frame.height(), frame.bytesPerLine());
+    }
+
+    const int plane = inputSize * inputSize;
+    float *red = blob.ptr<float>();
+    float *green = red + plane;
+    float *blue = green + plane;
+    const quint8 *pixels = frame.constBits();
+    const Tap *columnTaps = columns.data();
+
+    for (int y = 0; y < resizedHeight; ++y) {
+        const Tap &row = rows[y];
+        const quint8 *top = pixels + row.first;
+        const quint8 *bottom = pixels + row.second;
+        const int wy = row.weight;
+        const int offset = (padY + y) * inputSize + padX;
+        float *r = red + offset;
+        float *g = green + offset;
+        float *b = blue + offset;
+
+        for (int x = 0; x < resizedWidth; ++x) {
+            const Tap &column = columnTaps[x];
+            const int wx = column.weight;
+            const quint8 *tl = top + column.first;
+            const quint8 *tr = top + column.second;
+            const quint8 *bl = bottom + column.first;
+            const quint8 *br = bottom + column.second;
+
+            // Frames are RGB, which is the channel order the model expects
+            const int r0 = (tl[0] << 8) + (tr[0] - tl[0]) * wx;
+            const int r1 = (bl[0] << 8) + (br[0] - bl[0]) * wx;
+            const int g0 = (tl[1] << 8) + (tr[1] - tl[1]) * wx;
+            const int g1 = (bl[1] << 8) + (br[1] - bl[1]) * wx;
+            const int b0 = (tl[2] << 8) + (tr[2] - tl[2]) * wx;
+            const int b1 = (bl[2] << 8) + (br[2] - bl[2]) * wx;
+            r[x] = ((r0 << 8) + (r1 - r0) * wy) * kNormalise;
+            g[x] = ((g0 << 8) + (g1 - g0) * wy) * kNormalise;
+            b[x] = ((b0 << 8) + (b1 - b0) * wy) * kNormalise;
+        }
+    }
+    return blob;
+}
+
+void DetectionContext::selectAbove(const float *scores, int count, float threshold, std::vector<int> &indices) {
+    int i = 0;
+#if defined(Q_PROCESSOR_X86_64) || defined(__SSE2__) || defined(_M_X64)
+    // Almost every score is far below the threshold; test four at a time and
+    // only look at lanes that passed
+    const __m128 limit = _mm_set1_ps(threshold);
+    for (; i + 4 <= count; i += 4) {
+        int mask = _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(scores + i), limit));
+        for (int lane = i; mask != 0; mask >>= 1, ++lane) {
+            if (mask & 1) {
+                indices.push_back(lane);
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if (scores[i] >= threshold) {
+            indices.push_back(i);
+        }
+    }
+}
+
+void DetectionContext::parse(const cv::Mat &output, float scoreThreshold, float nmsThreshold,
+                             std::vector<Detection> &detections) {
+    detections.clear();
+
+    // One class: rows cx, cy, w, h, score, each N floats long
+    if (output.dims != 3 || output.size[1] < 5 || !output.isContinuous()) {
+        if (!warnedShape) {
+            warnedShape = true;
+            qWarning() << "[YOLO] Unexpected output shape; expected [1, 5, N]";
+        }
+        return;
+    }
+    const int count = output.size[2];
+    const float *cx = output.ptr<float>();
+    const float *cy = cx + count;
+    const float *w = cy + count;
+    const float *h = w + count;
+    const float *score = h + count;
+
+    candidates.clear();
+    selectAbove(score, count, scoreThreshold, candidates);
+    if (candidates.empty()) {
+        return;
+    }
+
+    // Network input coordinates back through the letterbox to frame pixels
+    const float inverse = static_cast<float>(1.0 / scale);
+    boxes.clear();
+    scores.clear();
+    for (int i : candidates) {
+        const float left = (cx[i] - w[i] * 0.5f - padX) * inverse;
+        const float top = (cy[i] - h[i] * 0.5f - padY) * inverse;
+        const float right = (cx[i] + w[i] * 0.5f - padX) * inverse;
+        const float bottom = (cy[i] + h[i] * 0.5f - padY) * inverse;
+
+        const int x1 = std::max(0, std::min(frameWidth, static_cast<int>(left)));
+        const int y1 = std::max(0, std::min(frameHeight, static_cast<int>(top)));
+        const int x2 = std::max(0, std::min(frameWidth, static_cast<int>(right)));
+        const int y2 = std::max(0, std::min(frameHeight, static_cast<int>(bottom)));
+
+        boxes.push_back(cv::Rect(x1, y1, x2 - x1, y2 - y1));
+        scores.push_back(score[i]);
+    }
+
+    kept.clear();
+    cv::dnn::NMSBoxes(boxes, scores, scoreThreshold, nmsThreshold, kept);
+
+    for (int i : kept) {
+        Detection detection;
+        detection.box = QRect(boxes[i].x, boxes[i].y, boxes[i].width, boxes[i].height);
+        detection.score = scores[i];
+        detections.push_back(detection);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef DETECTION_CONTEXT_H
+#define DETECTION_CONTEXT_H
+
+#include <QtGlobal>
+#include <QRect>
+#include <QSize>
+#include <opencv2/core.hpp>
+#include <vector>
+
+class FrameBuffer;
+
+// One detected object, in frame pixel coordinates
+struct Detection {
+    QRect box;
+    float score = 0.0f;
+};
+
+// Pre- and post-processing around one YOLO network, kept between frames so
+// nothing is allocated once the first frame of a given size has been seen.
+//   - prepare(): letterbox resize (bilinear, aspect kept, grey padding),
+//     scaling to 0..1 and the HWC to CHW split in one pass from the RGB888
+//     frame straight into the network's input tensor
+//   - parse(): reads the [1, 5, N] output in place (no transpose), picks
+//     candidates with an SSE2 threshold pass over the score row, maps them
+//     back through the letterbox to frame pixels and runs NMS
+// Only the thread running the network uses a context.
+class DetectionContext {
+public:
+    explicit DetectionContext(int inputSize);
+
+    // Fill the input tensor (1 x 3 x inputSize x inputSize, float) from frame
+    const cv::Mat &prepare(const FrameBuffer &frame);
+
+    // Detections of the last prepared frame from the network output, in frame
+    // pixel coordinates; detections is cleared first
+    void parse(const cv::Mat &output, float scoreThreshold, float nmsThreshold,
+               std::vector<Detection> &detections);
+
+    // Size of the last prepared frame
+    QSize frameSize() const { return QSize(frameWidth, frameHeight); }
+
+    // Append the index of every score >= threshold to indices, in order.
+    // Vectorized with SSE2 where available.
+    static void selectAbove(const float *scores, int count, float threshold, std::vector<int> &indices);
+
+private:
+    // One bilinear source pair along an axis, weight in 1/256 of the second
+    struct Tap {
+        int first;
+        int second;
+        int weight;
+    };
+
+    void rebuildGeometry(int width, int height, int stride);
+    static void buildTaps(std::vector<Tap> &taps, int sourceSize, int targetSize, double scale, int step);
+
+    int inputSize;
+    cv::Mat blob;
+
+    // Letterbox of the current frame geometry
+    int frameWidth;
+    int frameHeight;
+    int frameStride;
+    double scale;
+    int resizedWidth;
+    int resizedHeight;
+    int padX;
+    int padY;
+    std::vector<Tap> columns;  // Byte offsets within a source row
+    std::vector<Tap> rows;     // Byte offsets of source rows
+
+    // Post-processing scratch, reused between frames
+    std::vector<int> candidates;
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    std::vector<int> kept;
+    bool warnedShape;
+};
+
+#endif // DETECTION_CONTEXT_H
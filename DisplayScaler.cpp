@@ -0,0 +1,194 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: DisplayScaler.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the DisplayScaler class, which
+turns a published RGB888 frame into the RGB32 image
+painted on screen. Scaling, flipping and the format
+conversion happen in one pass per new frame, and
+the result is cached until the frame, the widget
+size or the flip settings change. A new frame of
+the same layout only has its changed rows redone.
+===================================================
+*/
+
+#include "DisplayScaler.h"
+#include <cstring>
+
+#if defined(Q_PROCESSOR_X86)
+#include <emmintrin.h>
+#endif
+
+DisplayScaler::DisplayScaler()
+    : cachedSequence(0),
+      cachedFlipHorizontal(false),
+      cachedFlipVertical(false),
+      cachedStamp(0),
+      rendered(0),
+      packed(0) {
+}
+
+void DisplayScaler::packRow(const quint8 *rgb888, quint32 *out, int pixels, bool reverse) {
+    if (reverse) {
+        out += pixels - 1;
+        for (int x = 0; x < pixels; ++x, rgb888 += 3) {
+            *out-- = 0xFF000000u | (quint32(rgb888[0]) << 16) | (quint32(rgb888[1]) << 8) | rgb888[2];
+        }
+    } else {
+        for (int x = 0; x < pixels; ++x, rgb888 += 3) {
+            *out++ = 0xFF000000u | (quint32(rgb888[0]) << 16) | (quint32(rgb888[1]) << 8) | rgb888[2];
+        }
+    }
+}
+
+void DisplayScaler::replicate2(const quint32 *src, quint32 *dst, int pixels) {
+    int x = 0;
+
+#if defined(Q_PROCESSOR_X86_64) || defined(__SSE2__) || defined(_M_X64)
+    // p0 p1 p2 p3 -> p0 p0 p1 p1 | p2 p2 p3 p3
+    for (; x + 4 <= pixels; x += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * x), _mm_unpacklo_epi32(v, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * x + 4), _mm_unpackhi_epi32(v, v));
+    }
+#endif
+
+    for (; x < pixels; ++x) {
+        dst[2 * x] = src[x];
+        dst[2 * x + 1] = src[x];
+    }
+}
+
+void DisplayScaler::rebuildColumnMap(int sourceWidth, int targetWidth) {
+    columnMap.resize(targetWidth);
+    for (int x = 0; x < targetWidth; ++x) {
+        columnMap[x] = static_cast<int>((qint64(x) * sourceWidth + sourceWidth / 2) / targetWidth);
+    }
+}
+
+void DisplayScaler::addBand(int first, int end) {
+    changed += QRect(placed.x(), placed.y() + first, placed.width(), end - first);
+}
+
+const QImage &DisplayScaler::render(const FrameBuffer &frame, const QSize &target, bool flipHorizontal, bool flipVertical) {
+    const int width = frame.width();
+    const int height = frame.height();
+    const bool sameLayout = target == cachedTarget && flipHorizontal == cachedFlipHorizontal
+        && flipVertical == cachedFlipVertical && QSize(width, height) == cachedFrameSize && !output.isNull();
+
+    changed = QRegion();
+    if (sameLayout && frame.sequence == cachedSequence) {
+        return output;
+    }
+
+    if (width <= 0 || height <= 0 || target.isEmpty()) {
+        output = QImage();
+        placed = QRect();
+        cachedFrameSize = QSize();
+        return output;
+    }
+
+    // Only rows that changed since the rendered frame, when its stamps allow
+    const quint32 *stamps = frame.rowStamps.data();
+    const bool partial = sameLayout && cachedStamp != 0 && frame.changeStamp > cachedStamp
+        && static_cast<int>(frame.rowStamps.size()) == height;
+
+    // Largest integer factor that fits; below 1x fall back to an aspect fit
+    const int factor = qMin(target.width() / width, target.height() / height);
+    const QSize scaled = factor >= 1 ? QSize(width * factor, height * factor)
+                                     : QSize(width, height).scaled(target, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+
+    if (output.size() != scaled) {
+        output = QImage(scaled, QImage::Format_RGB32);
+    }
+    if (factor < 1 && static_cast<int>(columnMap.size()) != scaled.width()) {
+        rebuildColumnMap(width, scaled.width());
+    }
+    placed = QRect(QPoint((target.width() - scaled.width()) / 2, (target.height() - scaled.height()) / 2), scaled);
+    sourceRow.resize(width);
+
+    const int outStride = output.bytesPerLine();
+    uchar *outBits = output.bits();
+    int outRow = 0;
+    int bandStart = -1;  // First output row of the current run of converted rows
+
+    if (factor >= 1) {
+        // Each source row is packed and widened once, then copied down factor - 1 times
+        for (int y = 0; y < height; ++y) {
+            const int sourceY = flipVertical ? height - 1 - y : y;
+            if (partial && stamps[sourceY] <= cachedStamp) {
+                if (bandStart >= 0) {
+                    addBand(bandStart, outRow);
+                    bandStart = -1;
+                }
+                outRow += factor;
+                continue;
+            }
+            if (bandStart < 0) {
+                bandStart = outRow;
+            }
+            packed++;
+            packRow(frame.constScanLine(sourceY), sourceRow.data(), width, flipHorizontal);
+
+            quint32 *first = reinterpret_cast<quint32 *>(outBits + outRow * outStride);
+            if (factor == 1) {
+                std::memcpy(first, sourceRow.data(), width * sizeof(quint32));
+            } else if (factor == 2) {
+                replicate2(sourceRow.data(), first, width);
+            } else {
+                quint32 *out = first;
+                for (int x = 0; x < width; ++x) {
+                    for (int k = 0; k < factor; ++k) {
+                        *out++ = sourceRow[x];
+                    }
+                }
+            }
+            for (int k = 1; k < factor; ++k) {
+                std::memcpy(outBits + (outRow + k) * outStride, first, scaled.width() * sizeof(quint32));
+            }
+            outRow += factor;
+        }
+    } else {
+        // Nearest-neighbour downscale; consecutive output rows never share a source row
+        for (; outRow < scaled.height(); ++outRow) {
+            int sourceY = static_cast<int>((qint64(outRow) * height + height / 2) / scaled.height());
+            if (flipVertical) {
+                sourceY = height - 1 - sourceY;
+            }
+            if (partial && stamps[sourceY] <= cachedStamp) {
+                if (bandStart >= 0) {
+                    addBand(bandStart, outRow);
+                    bandStart = -1;
+                }
+                continue;
+            }
+            if (bandStart < 0) {
+                bandStart = outRow;
+            }
+            packed++;
+            packRow(frame.constScanLine(sourceY), sourceRow.data(), width, flipHorizontal);
+
+            quint32 *out = reinterpret_cast<quint32 *>(outBits + outRow * outStride);
+            for (int x = 0; x < scaled.width(); ++x) {
+                out[x] = sourceRow[columnMap[x]];
+            }
+        }
+    }
+
+    if (bandStart >= 0) {
+        addBand(bandStart, outRow);
+    }
+
+    cachedSequence = frame.sequence;
+    cachedTarget = target;
+    cachedFlipHorizontal = flipHorizontal;
+    cachedFlipVertical = flipVertical;
+    cachedFrameSize = QSize(width, height);
+    cachedStamp = frame.changeStamp;
+    rendered++;
+    return output;
+}
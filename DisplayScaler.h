@@ -0,0 +1,72 @@
+#ifndef DISPLAY_SCALER_H
+#define DISPLAY_SCALER_H
+
+#include <QtGlobal>
+#include <QImage>
+#include <QRect>
+#include <QRegion>
+#include <QSize>
+#include <vector>
+#include "FramePool.h"
+
+// Produces the on-screen image of a frame once per new frame: scaled to fit
+// the widget, flipped, and converted to RGB32 (the raster paint engine's
+// native format) in a single pass, so paintEvent only has to blit it.
+// The largest integer factor that fits is used, replicating pixels (2x with
+// SSE2); a widget smaller than the frame gets a nearest-neighbour downscale.
+// When only the frame changed, just the rows whose change stamps are newer
+// than the rendered frame's are converted again. Only the GUI thread uses a
+// scaler.
+class DisplayScaler {
+public:
+    DisplayScaler();
+
+    // Image for frame at target size; rebuilt only when the frame, the size
+    // or the flips changed since the last call
+    const QImage &render(const FrameBuffer &frame, const QSize &target, bool flipHorizontal, bool flipVertical);
+
+    // Where the last rendered image goes inside the target, centred
+    QRect placement() const { return placed; }
+
+    // Part of the target the last render() call changed: bands of converted
+    // rows, the whole placement after a full render, empty on a cache hit
+    const QRegion &changedRegion() const { return changed; }
+
+    // Frames actually scaled (not served from the cache)
+    quint64 renderedFrames() const { return rendered; }
+
+    // Source rows packed to RGB32, whole frames and partial updates together.
+    // A downscaled image samples the frame, so it packs at most one source
+    // row per output row and fewer rows than a full-size display.
+    quint64 packedRows() const { return packed; }
+
+    // Pack one RGB888 row into RGB32, optionally reversed
+    static void packRow(const quint8 *rgb888, quint32 *out, int pixels, bool reverse);
+
+    // Repeat every pixel of src twice. Vectorized with SSE2 where available.
+    static void replicate2(const quint32 *src, quint32 *dst, int pixels);
+
+private:
+    void rebuildColumnMap(int sourceWidth, int targetWidth);
+
+    void addBand(int first, int end);
+
+    QImage output;
+    QRect placed;
+    QRegion changed;
+
+    // Cache key
+    quint64 cachedSequence;
+    QSize cachedTarget;
+    bool cachedFlipHorizontal;
+    bool cachedFlipVertical;
+    QSize cachedFrameSize;
+    quint32 cachedStamp;  // FrameBuffer::changeStamp of the rendered frame
+    quint64 rendered;
+    quint64 packed;
+
+    std::vector<quint32> sourceRow;  // One source row in RGB32, flips applied
+    std::vector<int> columnMap;      // Source column of each output column when downscaling
+};
+
+#endif // DISPLAY_SCALER_H
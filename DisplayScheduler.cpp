@@ -0,0 +1,102 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: DisplayScheduler.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the DisplayScheduler class,
+which paces repaints of the video widget to the
+display refresh rate. Only the newest published
+frame is ever painted; frames the monitor could
+not show are counted instead of queued.
+===================================================
+*/
+
+#include "DisplayScheduler.h"
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
+#include <QDebug>
+
+namespace {
+// Used when the screen does not report a sensible refresh rate
+const double kFallbackRefreshRate = 60.0;
+}
+
+DisplayScheduler::DisplayScheduler(const FramePool *pool, QWidget *target, QObject *parent)
+    : QObject(parent),
+      pool(pool),
+      target(target),
+      timer(new QTimer(this)),
+      rate(kFallbackRefreshRate),
+      lastSequence(0),
+      scheduled(0),
+      skipped(0),
+      repainted(0) {
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &DisplayScheduler::tick);
+}
+
+void DisplayScheduler::setRenderer(Renderer frameRenderer) {
+    renderer = frameRenderer;
+}
+
+void DisplayScheduler::start() {
+    QWindow *handle = target->window()->windowHandle();
+    if (handle != window) {
+        if (window) {
+            disconnect(window, &QWindow::screenChanged, this, &DisplayScheduler::setScreen);
+        }
+        window = handle;
+        if (window) {
+            // Moving the window to another monitor changes the refresh rate
+            connect(window, &QWindow::screenChanged, this, &DisplayScheduler::setScreen);
+        }
+    }
+
+    setScreen(window ? window->screen() : nullptr);
+}
+
+void DisplayScheduler::setScreen(QScreen *screen) {
+    if (!screen) {
+        screen = QGuiApplication::primaryScreen();
+    }
+
+    rate = (screen && screen->refreshRate() >= 1.0) ? screen->refreshRate() : kFallbackRefreshRate;
+    timer->start(qMax(1, qRound(1000.0 / rate)));
+    qDebug() << "Display scheduled at" << rate << "Hz";
+}
+
+void DisplayScheduler::stop() {
+    timer->stop();
+}
+
+void DisplayScheduler::tick() {
+    const quint64 sequence = pool->latestSequence();
+    if (sequence == lastSequence || !target->isVisible()) {
+        return;
+    }
+
+    // Everything published since the last repaint except the newest is never shown
+    if (lastSequence != 0) {
+        skipped += sequence - lastSequence - 1;
+    }
+    lastSequence = sequence;
+    scheduled++;
+
+    if (!renderer) {
+        repainted += quint64(target->width()) * target->height();
+        target->update();
+        return;
+    }
+
+    const QRegion region = renderer();
+    for (const QRect &area : region) {
+        repainted += quint64(area.width()) * area.height();
+    }
+    if (!region.isEmpty()) {
+        target->update(region);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef DISPLAY_SCHEDULER_H
+#define DISPLAY_SCHEDULER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QRegion>
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+#include "FramePool.h"
+
+class QScreen;
+class QWindow;
+
+// Repaints a widget at most once per display refresh, always with the newest
+// published frame. Reassembly only publishes; a timer on the GUI thread polls
+// the pool's sequence number once per refresh and requests a single update
+// when it moved. Frames published in between are counted as skipped rather
+// than queued, so display speed never holds back acquisition. With a renderer
+// set, the new frame is rendered first and only the region it changed is
+// repainted; a frame identical to the one on screen costs no repaint at all.
+class DisplayScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    // Renders the newest frame and returns the part of the target it changed
+    using Renderer = std::function<QRegion()>;
+
+    DisplayScheduler(const FramePool *pool, QWidget *target, QObject *parent = nullptr);
+
+    // Without a renderer the whole target is repainted for every new frame
+    void setRenderer(Renderer frameRenderer);
+
+    // Start polling at the refresh rate of the screen showing the target, and
+    // follow the target's window to other screens. Call once the target is
+    // shown; before that it has no window and the primary screen is used.
+    void start();
+    void stop();
+
+    // Refresh rate in use, in Hz
+    double refreshRate() const { return rate; }
+
+    // Repaints requested for a new frame, and published frames never shown
+    quint64 scheduledFrames() const { return scheduled; }
+    quint64 skippedFrames() const { return skipped; }
+
+    // Pixels of the target requested for repaint
+    quint64 repaintedArea() const { return repainted; }
+
+private slots:
+    void tick();
+    void setScreen(QScreen *screen);
+
+private:
+    const FramePool *pool;
+    QWidget *target;
+    QPointer<QWindow> window;  // Window whose screenChanged is followed
+    Renderer renderer;
+    QTimer *timer;
+    double rate;
+    quint64 lastSequence;
+    quint64 scheduled;
+    quint64 skipped;
+    quint64 repainted;
+};
+
+#endif // DISPLAY_SCHEDULER_H
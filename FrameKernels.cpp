@@ -0,0 +1,125 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: FrameKernels.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the geometry-specific frame
+kernels: marker classification, line decoding and
+missing row concealment. The loops are written once
+as a template over the geometry; the 400x400,
+640x480 and 800x800 sensors get instances with
+constant bounds and other sizes use the runtime
+instance.
+===================================================
+*/
+
+#include "FrameKernels.h"
+#include "FramePool.h"
+#include "Rgb565Decoder.h"
+#include "Rgb565ToneTable.h"
+
+namespace {
+// Geometry known at compile time
+template <int Width, int Height, int LineBytes>
+struct FixedGeometry {
+    explicit FixedGeometry(const StreamDescriptor &) {}
+
+    static constexpr int width() { return Width; }
+    static constexpr int height() { return Height; }
+    static constexpr int lineBytes() { return LineBytes; }
+    static constexpr int pixelsPerLine() { return Width < LineBytes / 2 ? Width : LineBytes / 2; }
+    static constexpr int rowBytes() { return Width * 3; }
+
+    static bool matches(const StreamDescriptor &stream) {
+        return stream.width == Width && stream.height == Height && stream.bytesPerLine == LineBytes;
+    }
+
+    // Full-line decoder of the CPU's best kernel with a constant pixel count
+    static Rgb565Decoder::FixedLineFunction lineDecoder() {
+        return Rgb565Decoder::fixedFunction<pixelsPerLine()>(Rgb565Decoder::bestKernel());
+    }
+};
+
+// Geometry read from the stream descriptor
+struct RuntimeGeometry {
+    explicit RuntimeGeometry(const StreamDescriptor &stream)
+        : w(stream.width), h(stream.height), bytes(stream.bytesPerLine) {}
+
+    int width() const { return w; }
+    int height() const { return h; }
+    int lineBytes() const { return bytes; }
+    int pixelsPerLine() const { return qMin(w, bytes / 2); }
+    int rowBytes() const { return w * 3; }
+
+    // No constant width, so full lines use the runtime decoder
+    static Rgb565Decoder::FixedLineFunction lineDecoder() { return nullptr; }
+
+    int w;
+    int h;
+    int bytes;
+};
+
+template <typename Geometry>
+class GeometryKernels : public FrameKernels {
+public:
+    GeometryKernels(const StreamDescriptor &stream, const char *kernelName)
+        : geometry(stream),
+          startMarker(stream.startMarker),
+          endMarker(stream.endMarker),
+          fullLineDecoder(Geometry::lineDecoder()),
+          kernelName(kernelName) {}
+
+    PacketClassifier::Kind classify(const quint8 *payload, int size) const override {
+        return PacketClassifier::classify(payload, size, startMarker, endMarker);
+    }
+
+    void decodeLine(const quint8 *payload, int size, quint8 *row, const quint32 *toneEntries) const override {
+        // Full-size lines, the normal case, decode a constant pixel count
+        if (fullLineDecoder && !toneEntries && size >= geometry.lineBytes()) {
+            fullLineDecoder(payload, row);
+            return;
+        }
+        const int pixels = size >= geometry.lineBytes() ? geometry.pixelsPerLine()
+                                                        : qMin(size / 2, geometry.pixelsPerLine());
+        if (toneEntries) {
+            Rgb565ToneTable::decodeLine(toneEntries, payload, row, pixels);
+        } else {
+            Rgb565Decoder::decodeLine(payload, row, pixels);
+        }
+    }
+
+    ConcealmentResult concealMissingRows(FrameBuffer &frame, const quint8 *received,
+                                         const FrameBuffer *previous) const override {
+        return RowConcealer::conceal(frame, received, geometry.height(), geometry.rowBytes(), previous);
+    }
+
+    const char *name() const override { return kernelName; }
+
+private:
+    Geometry geometry;
+    quint8 startMarker;
+    quint8 endMarker;
+    Rgb565Decoder::FixedLineFunction fullLineDecoder;  // Null without a constant width
+    const char *kernelName;
+};
+
+typedef FixedGeometry<400, 400, 800> Geometry400x400;
+typedef FixedGeometry<640, 480, 1280> Geometry640x480;
+typedef FixedGeometry<800, 800, 1600> Geometry800x800;
+}
+
+std::unique_ptr<FrameKernels> FrameKernels::create(const StreamDescriptor &stream) {
+    if (Geometry400x400::matches(stream)) {
+        return std::unique_ptr<FrameKernels>(new GeometryKernels<Geometry400x400>(stream, "400x400 fixed"));
+    }
+    if (Geometry640x480::matches(stream)) {
+        return std::unique_ptr<FrameKernels>(new GeometryKernels<Geometry640x480>(stream, "640x480 fixed"));
+    }
+    if (Geometry800x800::matches(stream)) {
+        return std::unique_ptr<FrameKernels>(new GeometryKernels<Geometry800x800>(stream, "800x800 fixed"));
+    }
+    return std::unique_ptr<FrameKernels>(new GeometryKernels<RuntimeGeometry>(stream, "generic"));
+}
@@ -0,0 +1,39 @@
+#ifndef FRAME_KERNELS_H
+#define FRAME_KERNELS_H
+
+#include <QtGlobal>
+#include <memory>
+#include "PacketClassifier.h"
+#include "RowConcealer.h"
+#include "StreamConfig.h"
+
+class FrameBuffer;
+
+// Per-geometry hot loops used by frame reassembly. Common sensor geometries
+// get a template instance whose width, height and line size are compile-time
+// constants; anything else runs the same code with runtime bounds.
+class FrameKernels {
+public:
+    virtual ~FrameKernels() {}
+
+    // Sort a payload (header stripped) into start, end or line packet
+    virtual PacketClassifier::Kind classify(const quint8 *payload, int size) const = 0;
+
+    // Decode one line payload into an RGB888 row, through toneEntries (an
+    // Rgb565ToneTable's entries, brightness and gamma included) when not null,
+    // else with the SIMD decoder
+    virtual void decodeLine(const quint8 *payload, int size, quint8 *row, const quint32 *toneEntries) const = 0;
+
+    // Conceal every row with received[row] == 0, using previous (may be null)
+    // for long gaps
+    virtual ConcealmentResult concealMissingRows(FrameBuffer &frame, const quint8 *received,
+                                                 const FrameBuffer *previous) const = 0;
+
+    // Short description for logs, e.g. "400x400 fixed"
+    virtual const char *name() const = 0;
+
+    // Pick the specialised kernels for stream, or the generic ones
+    static std::unique_ptr<FrameKernels> create(const StreamDescriptor &stream);
+};
+
+#endif // FRAME_KERNELS_H
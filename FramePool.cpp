@@ -0,0 +1,111 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: FramePool.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the frame pool shared by frame
+reassembly, the display and every other consumer of
+finished frames. Buffers are allocated once; a frame
+is published with an atomic pointer swap and read
+through reference-counted handles, so readers never
+copy the frame or wait on a lock.
+===================================================
+*/
+
+#include "FramePool.h"
+
+FrameBuffer::FrameBuffer(int width, int height)
+    : copiedRows(height, 0),
+      rowStamps(height, 0),
+      frameWidth(width),
+      frameHeight(height),
+      stride((width * 3 + 3) & ~3),  // QImage scanlines are 32-bit aligned
+      pixels(static_cast<size_t>(stride) * height, 0) {
+}
+
+namespace {
+void releaseImageBuffer(void *info) {
+    // Drops the reference taken in FrameHandle::image()
+    FrameHandle *handle = static_cast<FrameHandle *>(info);
+    delete handle;
+}
+}
+
+QImage FrameHandle::image() const {
+    if (!buffer) {
+        return QImage();
+    }
+
+    // The const-data constructor makes any write to the QImage detach first
+    return QImage(buffer->constBits(), buffer->width(), buffer->height(), buffer->bytesPerLine(),
+                  QImage::Format_RGB888, releaseImageBuffer, new FrameHandle(*this));
+}
+
+FramePool::FramePool(int width, int height, int count)
+    : frameWidth(width),
+      frameHeight(height) {
+    // Writer, published and displayed frames need three buffers at minimum
+    const int total = qMax(count, 3);
+    buffers.reserve(total);
+    for (int i = 0; i < total; ++i) {
+        buffers.push_back(new FrameBuffer(width, height));
+    }
+}
+
+FramePool::~FramePool() {
+    FrameBuffer *current = published.exchange(nullptr);
+    if (current) {
+        current->release();
+    }
+    for (FrameBuffer *buffer : buffers) {
+        delete buffer;
+    }
+}
+
+FrameBuffer *FramePool::acquireWrite() {
+    for (FrameBuffer *buffer : buffers) {
+        int expected = 0;
+        if (buffer->refs.compare_exchange_strong(expected, WriterRef, std::memory_order_acquire)) {
+            return buffer;
+        }
+    }
+    exhausted.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void FramePool::releaseWrite(FrameBuffer *buffer) {
+    buffer->refs.fetch_sub(WriterRef, std::memory_order_release);
+}
+
+void FramePool::publish(FrameBuffer *buffer) {
+    buffer->sequence = ++nextSequence;
+
+    // The writer's claim turns into the reference held by the published slot
+    buffer->refs.fetch_add(1 - WriterRef, std::memory_order_release);
+    FrameBuffer *previous = published.exchange(buffer);
+    if (previous) {
+        previous->refs.fetch_sub(1);  // Ordered after the exchange, see latest()
+    }
+    publishedSequence.store(buffer->sequence, std::memory_order_release);
+}
+
+FrameHandle FramePool::latest() const {
+    for (;;) {
+        FrameBuffer *current = published.load();
+        if (!current) {
+            return FrameHandle();
+        }
+
+        // Sequentially consistent so the re-check below cannot be ordered
+        // before the increment: if the buffer is still published afterwards,
+        // publish() has not dropped its reference yet and no writer can claim it
+        current->refs.fetch_add(1);
+        if (published.load() == current) {
+            return FrameHandle(current);
+        }
+        current->release();
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <QtGlobal>
+#include <QImage>
+#include <atomic>
+#include <vector>
+
+class FramePool;
+
+// One preallocated RGB888 frame. Ownership rotates between the writer
+// (reassembly), the pool's published slot and any number of readers; the
+// reference count decides when the buffer may be written again.
+class FrameBuffer {
+public:
+    int width() const { return frameWidth; }
+    int height() const { return frameHeight; }
+    int bytesPerLine() const { return stride; }
+
+    quint8 *bits() { return pixels.data(); }
+    const quint8 *constBits() const { return pixels.data(); }
+    quint8 *scanLine(int row) { return pixels.data() + row * stride; }
+    const quint8 *constScanLine(int row) const { return pixels.data() + row * stride; }
+
+    // Metadata filled in by the writer before publishing
+    quint64 sequence = 0;      // Monotonic publish order, assigned by the pool
+    quint16 frameId = 0;       // Frame ID from the packet header
+    bool complete = false;     // Every line arrived
+    int missingLines = 0;      // Rows that had to be filled in
+    int interpolatedLines = 0; // Missing rows interpolated from their neighbours
+    int temporalLines = 0;     // Missing rows copied from the previous frame
+    int changedRows = 0;       // Rows that differ from the previous frame (missing rows
+                               // count unless they were copied from it)
+    qint64 arrivalNs = 0;      // Receive time of the newest line (wall clock ns)
+    qint64 publishNs = 0;      // When the frame was published (wall clock ns)
+
+    // 1 for each row concealment copied from the previous frame; only set
+    // for frames with temporalLines > 0
+    std::vector<quint8> copiedRows;
+
+    // Dirty-row tracking: changeStamp goes up by one per retired frame, and
+    // each row holds the stamp of the frame it last changed in. Rows with a
+    // stamp at or below another frame's changeStamp are identical in both.
+    quint32 changeStamp = 0;
+    std::vector<quint32> rowStamps;
+
+private:
+    friend class FramePool;
+    friend class FrameHandle;
+
+    FrameBuffer(int width, int height);
+
+    void addRef() { refs.fetch_add(1, std::memory_order_relaxed); }
+    void release() { refs.fetch_sub(1, std::memory_order_acq_rel); }
+
+    int frameWidth;
+    int frameHeight;
+    int stride;
+    std::vector<quint8> pixels;
+    std::atomic<int> refs{0};
+};
+
+// Reference-counted read-only handle to a published frame. Copying a handle
+// is one atomic increment; the frame stays intact while any handle exists.
+class FrameHandle {
+public:
+    FrameHandle() : buffer(nullptr) {}
+    FrameHandle(const FrameHandle &other) : buffer(other.buffer) { if (buffer) buffer->addRef(); }
+    FrameHandle(FrameHandle &&other) noexcept : buffer(other.buffer) { other.buffer = nullptr; }
+    ~FrameHandle() { reset(); }
+
+    FrameHandle &operator=(FrameHandle other) {
+        std::swap(buffer, other.buffer);
+        return *this;
+    }
+
+    bool isNull() const { return buffer == nullptr; }
+    explicit operator bool() const { return buffer != nullptr; }
+
+    const FrameBuffer *operator->() const { return buffer; }
+    const FrameBuffer &operator*() const { return *buffer; }
+
+    void reset() {
+        if (buffer) {
+            buffer->release();
+            buffer = nullptr;
+        }
+    }
+
+    // Wrap the frame in a read-only QImage without copying; the image keeps
+    // its own reference until it is destroyed
+    QImage image() const;
+
+private:
+    friend class FramePool;
+
+    // Takes over a reference the caller already holds
+    explicit FrameHandle(FrameBuffer *adopted) : buffer(adopted) {}
+
+    FrameBuffer *buffer;
+};
+
+// Fixed set of frame buffers rotated between writer, published slot and
+// readers. Publishing is a single atomic pointer swap, so readers never see
+// a half-written frame and never block the writer.
+class FramePool {
+public:
+    FramePool(int width, int height, int count);
+    ~FramePool();
+
+    int width() const { return frameWidth; }
+    int height() const { return frameHeight; }
+
+    // Claim a buffer nobody references; nullptr when all are in use
+    FrameBuffer *acquireWrite();
+
+    // Give a claimed buffer back without publishing it
+    void releaseWrite(FrameBuffer *buffer);
+
+    // Make a claimed buffer the newest published frame
+    void publish(FrameBuffer *buffer);
+
+    // Handle to the newest published frame (null before the first publish)
+    FrameHandle latest() const;
+
+    // Sequence of the newest published frame, 0 before the first publish.
+    // Cheaper than latest() for checking whether anything new arrived.
+    quint64 latestSequence() const { return publishedSequence.load(std::memory_order_acquire); }
+
+    // Number of times acquireWrite() found no free buffer
+    quint64 exhaustedCount() const { return exhausted.load(std::memory_order_relaxed); }
+
+private:
+    Q_DISABLE_COPY(FramePool)
+
+    // Reference held by a writer; larger than any realistic reader count
+    static const int WriterRef = 1 << 20;
+
+    int frameWidth;
+    int frameHeight;
+    std::vector<FrameBuffer *> buffers;
+    std::atomic<FrameBuffer *> published{nullptr};
+    std::atomic<quint64> publishedSequence{0};
+    quint64 nextSequence = 0;   // Writer thread only
+    std::atomic<quint64> exhausted{0};
+};
+
+#endif // FRAME_POOL_H
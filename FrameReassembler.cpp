@@ -0,0 +1,314 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: FrameReassembler.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the FrameReassembler class,
+which turns the raw line packets coming from the
+FPGA into complete frames. Lines are placed by the
+frame ID and line index in the packet header, so
+lost or reordered packets no longer shift the rest
+of the image, and several frames can be in flight
+at the same time.
+===================================================
+*/
+
+#include "FrameReassembler.h"
+#include "Rgb565ToneTable.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// A frame ID this far behind the last retired frame means the sender restarted
+const int kResyncDistance = 1024;
+
+inline quint16 readBigEndian16(const char *data) {
+    return static_cast<quint16>((static_cast<quint8>(data[0]) << 8) | static_cast<quint8>(data[1]));
+}
+}
+
+FrameReassembler::FrameReassembler(const StreamDescriptor &stream, FramePool *pool, int windowSize, int supersedeLines)
+    : stream(stream),
+      kernels(FrameKernels::create(stream)),
+      toneTable(nullptr),
+      pool(pool),
+      window(qMax(windowSize, 1)),
+      supersedeLines(qBound(1, supersedeLines, stream.height)),
+      haveRetired(false),
+      lastRetiredId(0),
+      previousHashes(stream.height, 0),
+      changeStamp(0),
+      rowStamps(stream.height, 0),
+      rowChanged(stream.height, 0) {
+    for (Frame &frame : window) {
+        frame.received.assign(stream.height, 0);
+        frame.lineHashes.assign(stream.height, 0);
+    }
+    qDebug() << "Frame kernels:" << kernels->name();
+}
+
+void FrameReassembler::setFrameHandler(FrameHandler frameHandler) {
+    handler = frameHandler;
+}
+
+void FrameReassembler::setToneTable(Rgb565ToneTable *table) {
+    toneTable = table;
+}
+
+void FrameReassembler::addPacket(const char *data, int size, qint64 arrivalNs) {
+    counters.packets++;
+
+    if (size <= stream.headerSize) {
+        counters.runtPackets++;
+        return;
+    }
+
+    const quint16 frameId = readBigEndian16(data + stream.frameIdOffset);
+    const quint8 *payload = reinterpret_cast<const quint8 *>(data + stream.headerSize);
+    const int payloadSize = size - stream.headerSize;
+
+    const PacketClassifier::Kind kind = kernels->classify(payload, payloadSize);
+    const bool isStart = kind == PacketClassifier::StartPacket;
+    const bool isEnd = kind == PacketClassifier::EndPacket;
+
+    if (haveRetired && !isNewer(frameId, lastRetiredId)) {
+        if (static_cast<qint16>(frameId - lastRetiredId) > -kResyncDistance) {
+            if (!isStart && !isEnd) {
+                counters.lateLines++;  // Its frame is already gone
+            }
+            return;
+        }
+        // Sender restarted its frame counter: drop everything open and start over
+        flush();
+        haveRetired = false;
+    }
+
+    Frame *frame = findOrOpen(frameId);
+
+    if (isStart) {
+        frame->startSeen = true;
+        return;
+    }
+
+    if (isEnd) {
+        frame->endSeen = true;
+        return;
+    }
+
+    const int row = readBigEndian16(data + stream.lineIndexOffset);
+    if (row >= stream.height) {
+        counters.outOfRangeLines++;
+        return;
+    }
+
+    if (frame->received[row]) {
+        counters.duplicateLines++;
+        return;
+    }
+
+    // Decode straight into the frame's RGB888 row
+    if (frame->buffer) {
+        kernels->decodeLine(payload, payloadSize, frame->buffer->scanLine(row), frame->toneEntries.get());
+    }
+    frame->lineHashes[row] = lineHash(payload, payloadSize);
+    frame->received[row] = 1;
+    frame->linesReceived++;
+    frame->lastArrivalNs = arrivalNs;
+
+    if (frame->linesReceived == supersedeLines) {
+        retireOlderThan(frameId);  // The newer frame is well under way
+    }
+
+    if (frame->linesReceived == stream.height) {
+        retireOlderThan(frameId);
+        retire(*frame);
+    }
+}
+
+void FrameReassembler::flush() {
+    while (Frame *frame = oldestOpen()) {
+        retire(*frame);
+    }
+}
+
+FrameReassembler::Frame *FrameReassembler::findOrOpen(quint16 frameId) {
+    Frame *freeSlot = nullptr;
+    for (Frame &frame : window) {
+        if (frame.open && frame.frameId == frameId) {
+            return &frame;
+        }
+        if (!frame.open && !freeSlot) {
+            freeSlot = &frame;
+        }
+    }
+
+    if (!freeSlot) {
+        // Window full: the oldest open frame is superseded
+        freeSlot = oldestOpen();
+        retire(*freeSlot);
+    }
+
+    // Slider changes take effect from this frame on; older open frames keep
+    // decoding with their own table
+    if (toneTable) {
+        toneTable->refresh();
+        freeSlot->toneEntries = toneTable->current();
+    }
+
+    freeSlot->frameId = frameId;
+    freeSlot->open = true;
+    freeSlot->startSeen = false;
+    freeSlot->endSeen = false;
+    freeSlot->linesReceived = 0;
+    freeSlot->lastArrivalNs = 0;
+    freeSlot->buffer = pool->acquireWrite();
+    std::fill(freeSlot->received.begin(), freeSlot->received.end(), 0);
+    return freeSlot;
+}
+
+FrameReassembler::Frame *FrameReassembler::oldestOpen() {
+    Frame *oldest = nullptr;
+    for (Frame &frame : window) {
+        if (frame.open && (!oldest || isNewer(oldest->frameId, frame.frameId))) {
+            oldest = &frame;
+        }
+    }
+    return oldest;
+}
+
+void FrameReassembler::retireOlderThan(quint16 frameId) {
+    for (;;) {
+        Frame *oldest = oldestOpen();
+        if (!oldest || !isNewer(frameId, oldest->frameId)) {
+            return;
+        }
+        retire(*oldest);
+    }
+}
+
+quint32 FrameReassembler::lineHash(const quint8 *data, int size) {
+    // FNV-1a over 64-bit words; each step is a bijection, so two payloads
+    // differing in one word always differ before the final fold
+    const quint64 prime = 0x100000001b3ULL;
+    quint64 hash = 0xcbf29ce484222325ULL;
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        quint64 word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return static_cast<quint32>(hash ^ (hash >> 32)) | 1u;
+}
+
+int FrameReassembler::countChangedRows(const Frame &frame) {
+    const FrameBuffer &buffer = *frame.buffer;
+    const bool copied = buffer.temporalLines > 0;
+    int changed = 0;
+    for (int row = 0; row < stream.height; ++row) {
+        quint32 hash = 0;  // Interpolated: treated as changed, now and next frame
+        if (frame.received[row]) {
+            hash = frame.lineHashes[row];
+        } else if (copied && buffer.copiedRows[row]) {
+            hash = previousHashes[row];  // Same pixels as the previous frame
+        }
+        rowChanged[row] = hash == 0 || hash != previousHashes[row];
+        changed += rowChanged[row];
+        previousHashes[row] = hash;
+    }
+    return changed;
+}
+
+void FrameReassembler::invalidateRows() {
+    invalidateRequested.store(true, std::memory_order_relaxed);
+}
+
+void FrameReassembler::setChangeSpread(int rows) {
+    changeSpread.store(qMax(0, rows), std::memory_order_relaxed);
+}
+
+void FrameReassembler::stampChangedRows(FrameBuffer &buffer) {
+    changeStamp++;
+    const int height = stream.height;
+    if (invalidateRequested.exchange(false, std::memory_order_relaxed)) {
+        std::fill(rowStamps.begin(), rowStamps.end(), changeStamp);
+    } else {
+        const int spread = changeSpread.load(std::memory_order_relaxed);
+        for (int row = 0; row < height; ++row) {
+            if (!rowChanged[row]) {
+                continue;
+            }
+            const int first = qMax(0, row - spread);
+            const int end = qMin(height, row + spread + 1);
+            std::fill(rowStamps.begin() + first, rowStamps.begin() + end, changeStamp);
+        }
+    }
+    buffer.changeStamp = changeStamp;
+    buffer.rowStamps = rowStamps;  // Same size, so no allocation
+}
+
+void FrameReassembler::retire(Frame &frame) {
+    const bool complete = frame.linesReceived == stream.height;
+
+    if (frame.linesReceived == 0) {
+        counters.framesEmpty++;
+    } else if (!frame.buffer) {
+        counters.framesNoBuffer++;
+    } else {
+        if (complete) {
+            counters.framesComplete++;
+        } else {
+            counters.framesIncomplete++;
+            if (!frame.endSeen) {
+                counters.missingEndMarkers++;
+            }
+        }
+        if (!frame.startSeen) {
+            counters.missingStartMarkers++;
+        }
+        ConcealmentResult concealment;
+        if (!complete) {
+            // The newest published frame is the previous one; published
+            // buffers are never written, so it is safe to read from here
+            FrameHandle previous = pool->latest();
+            concealment = kernels->concealMissingRows(*frame.buffer, frame.received.data(),
+                                                      previous.isNull() ? nullptr : &*previous);
+            counters.interpolatedLines += concealment.interpolatedRows;
+            counters.temporalLines += concealment.temporalRows;
+        }
+        frame.buffer->frameId = frame.frameId;
+        frame.buffer->arrivalNs = frame.lastArrivalNs;
+        frame.buffer->complete = complete;
+        frame.buffer->missingLines = concealment.missingRows;
+        frame.buffer->interpolatedLines = concealment.interpolatedRows;
+        frame.buffer->temporalLines = concealment.temporalRows;
+        frame.buffer->changedRows = countChangedRows(frame);
+        if (frame.toneEntries != publishedToneEntries) {
+            // First frame with a new tone table: every row looks different
+            publishedToneEntries = frame.toneEntries;
+            invalidateRows();
+        }
+        stampChangedRows(*frame.buffer);
+        if (handler) {
+            handler(frame, complete);
+        }
+    }
+
+    if (frame.buffer) {
+        pool->releaseWrite(frame.buffer);  // Not taken by the handler
+        frame.buffer = nullptr;
+    }
+    frame.toneEntries.reset();
+
+    if (!haveRetired || isNewer(frame.frameId, lastRetiredId)) {
+        lastRetiredId = frame.frameId;
+        haveRetired = true;
+    }
+    frame.open = false;
+}
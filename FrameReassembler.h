@@ -0,0 +1,137 @@
+#ifndef FRAME_REASSEMBLER_H
+#define FRAME_REASSEMBLER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "FrameKernels.h"
+#include "FramePool.h"
+#include "PipelineMetrics.h"
+#include "Rgb565ToneTable.h"
+#include "StreamConfig.h"
+
+// Rebuilds frames from line packets using the frame ID and line index carried
+// in the packet header (offsets come from the stream descriptor, by default):
+//   bytes 0-1  frame ID   (big-endian, wraps at 65536)
+//   bytes 2-3  line index (big-endian, ignored for marker packets)
+// Lines are placed at their real row whatever order they arrive in. A small
+// window of frames is kept open so reordered packets from neighbouring frames
+// land in the right one; a frame is retired once all of its lines arrived or
+// once a newer frame supersedes it. Each line is decoded to RGB888 as soon as
+// it arrives, straight into a buffer claimed from the frame pool, so retiring
+// a frame costs no conversion or copy. Each line's payload is also hashed, and
+// comparing the hashes with the previous frame's gives every frame a cheap
+// count of changed rows and the per-row change stamps the display uses to
+// convert and repaint only what changed.
+class FrameReassembler {
+public:
+    struct Frame {
+        quint16 frameId = 0;
+        bool open = false;
+        bool startSeen = false;
+        bool endSeen = false;
+        int linesReceived = 0;
+        qint64 lastArrivalNs = 0;       // Receive time of the newest line
+        FrameBuffer *buffer = nullptr;  // Pool buffer being written, null if the pool ran dry
+        std::vector<quint8> received;   // 1 for each row that arrived
+        std::vector<quint32> lineHashes; // lineHash() of each arrived row's payload
+        Rgb565ToneTable::Entries toneEntries; // Tone table the frame decodes with, null for SIMD
+    };
+
+    // Counted on the drain thread, readable from any thread
+    struct Stats {
+        MetricCounter packets;
+        MetricCounter framesComplete;     // Retired with every line present
+        MetricCounter framesIncomplete;   // Retired with missing lines
+        MetricCounter framesEmpty;        // Only markers arrived, nothing to show
+        MetricCounter framesNoBuffer;     // Dropped because every pool buffer was in use
+        MetricCounter duplicateLines;
+        MetricCounter outOfRangeLines;    // Line index beyond the frame height
+        MetricCounter lateLines;          // Arrived after their frame was retired
+        MetricCounter runtPackets;        // No payload after the header
+        MetricCounter missingStartMarkers;
+        MetricCounter missingEndMarkers;
+        MetricCounter interpolatedLines;  // Concealed from neighbouring rows
+        MetricCounter temporalLines;      // Concealed from the previous frame
+    };
+
+    // Called on retire; complete is false when the frame still misses lines,
+    // which have already been concealed. The handler takes the buffer by
+    // publishing it and clearing frame.buffer, otherwise it goes back to the
+    // pool.
+    using FrameHandler = std::function<void(Frame &frame, bool complete)>;
+
+    // windowSize frames may be open at once; an older frame is superseded as
+    // soon as a newer one has received supersedeLines lines
+    FrameReassembler(const StreamDescriptor &stream, FramePool *pool, int windowSize = 3, int supersedeLines = 32);
+
+    const StreamDescriptor &streamDescriptor() const { return stream; }
+
+    void setFrameHandler(FrameHandler handler);
+
+    // Decode through a fused RGB565 + tone table; a newly built table is
+    // adopted whenever a frame is opened, and frames already open finish
+    // with the table they started with. Null uses the SIMD decoder.
+    void setToneTable(Rgb565ToneTable *table);
+
+    // Feed one raw datagram (header included) received at arrivalNs
+    void addPacket(const char *data, int size, qint64 arrivalNs = 0);
+
+    // Retire every open frame, oldest first
+    void flush();
+
+    const Stats &stats() const { return counters; }
+
+    // Count every row of the next retired frame as changed, e.g. after the
+    // image adjustments changed (any thread)
+    void invalidateRows();
+
+    // Rows above and below each changed row that change with it, for
+    // neighbourhood filters applied after reassembly (any thread)
+    void setChangeSpread(int rows);
+
+    // Hash of one line's payload, never 0. Lines with equal payloads decode
+    // to equal rows.
+    static quint32 lineHash(const quint8 *data, int size);
+
+private:
+    Q_DISABLE_COPY(FrameReassembler)
+
+    static bool isNewer(quint16 a, quint16 b) { return static_cast<qint16>(a - b) > 0; }
+
+    Frame *findOrOpen(quint16 frameId);
+    Frame *oldestOpen();
+    void retire(Frame &frame);
+    void retireOlderThan(quint16 frameId);
+    int countChangedRows(const Frame &frame);
+    void stampChangedRows(FrameBuffer &buffer);
+
+    StreamDescriptor stream;
+    std::unique_ptr<FrameKernels> kernels;
+    Rgb565ToneTable *toneTable;
+    Rgb565ToneTable::Entries publishedToneEntries;  // Table of the last published frame
+    FramePool *pool;
+    std::vector<Frame> window;
+    int supersedeLines;
+    FrameHandler handler;
+
+    bool haveRetired;
+    quint16 lastRetiredId;
+
+    // Row hashes of the last frame handed to the frame handler; 0 where the
+    // content is unknown (rows interpolated by concealment)
+    std::vector<quint32> previousHashes;
+
+    // Change stamps of the rows of the last retired frame
+    quint32 changeStamp;
+    std::vector<quint32> rowStamps;
+    std::vector<quint8> rowChanged;  // Rows countChangedRows() found changed
+    std::atomic<bool> invalidateRequested{false};
+    std::atomic<int> changeSpread{0};
+
+    Stats counters;
+};
+
+#endif // FRAME_REASSEMBLER_H
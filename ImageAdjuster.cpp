@@ -0,0 +1,260 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: ImageAdjuster.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the ImageAdjuster class, which
+applies the brightness, gamma, sharpness and denoise
+settings from the control panel to every frame.
+Tone uses a lookup table, the filters are separable
+3x3 kernels with SSE2 inner loops, and all stages
+are split into row tiles run on the thread pool.
+===================================================
+*/
+
+#include "ImageAdjuster.h"
+#include "FramePool.h"
+#include <QThread>
+#include <QtConcurrent>
+#include <cmath>
+
+#if defined(Q_PROCESSOR_X86)
+#include <emmintrin.h>
+#endif
+
+namespace {
+const int kNeutralBrightness = 50;
+const int kNeutralGamma = 0;
+
+// Tiles per worker thread, so uneven tiles still balance out
+const int kTilesPerThread = 2;
+const int kMinTileRows = 16;
+
+// 65536 / kernel weight for the 3x3 filters, (2 + centreWeight)^2
+inline int reciprocalFor(int centreWeight) {
+    const int total = (2 + centreWeight) * (2 + centreWeight);
+    return (65536 + total / 2) / total;
+}
+
+// Rows concealment copied from the previous frame were adjusted with it
+inline bool isCopiedRow(const FrameBuffer &frame, int row) {
+    return frame.temporalLines > 0 && frame.copiedRows[row];
+}
+}
+
+ImageAdjuster::ImageAdjuster()
+    : brightness(kNeutralBrightness),
+      gamma(kNeutralGamma),
+      sharpness(0),
+      denoise(0),
+      toneInDecode(false),
+      toneBrightness(kNeutralBrightness),
+      toneGamma(kNeutralGamma) {
+    rebuildToneTable(toneBrightness, toneGamma);
+}
+
+void ImageAdjuster::setBrightness(int value) {
+    brightness.store(qBound(0, value, 100), std::memory_order_relaxed);
+}
+
+void ImageAdjuster::setGamma(int value) {
+    gamma.store(qBound(-100, value, 100), std::memory_order_relaxed);
+}
+
+void ImageAdjuster::setSharpness(int value) {
+    sharpness.store(qBound(0, value, 100), std::memory_order_relaxed);
+}
+
+void ImageAdjuster::setDenoise(int value) {
+    denoise.store(qBound(0, value, 100), std::memory_order_relaxed);
+}
+
+void ImageAdjuster::setToneInDecode(bool enabled) {
+    toneInDecode.store(enabled, std::memory_order_relaxed);
+}
+
+int ImageAdjuster::rowReach() const {
+    // Both filters are 3x3 and run one after the other
+    return (sharpness.load(std::memory_order_relaxed) > 0 ? 1 : 0)
+        + (denoise.load(std::memory_order_relaxed) > 0 ? 1 : 0);
+}
+
+bool ImageAdjuster::isNeutral() const {
+    const bool toneNeutral = toneInDecode.load(std::memory_order_relaxed)
+        || (brightness.load(std::memory_order_relaxed) == kNeutralBrightness
+            && gamma.load(std::memory_order_relaxed) == kNeutralGamma);
+    return toneNeutral
+        && sharpness.load(std::memory_order_relaxed) == 0
+        && denoise.load(std::memory_order_relaxed) == 0;
+}
+
+void ImageAdjuster::buildToneCurve(int brightnessValue, int gammaValue, quint8 curve[256]) {
+    // Gamma +100 lifts midtones with exponent 0.5, -100 darkens with 2.0;
+    // brightness shifts the result by up to +-100 levels
+    const double exponent = std::pow(2.0, -gammaValue / 100.0);
+    const double offset = (brightnessValue - kNeutralBrightness) * 2.0;
+    for (int i = 0; i < 256; ++i) {
+        const double value = 255.0 * std::pow(i / 255.0, exponent) + offset;
+        curve[i] = static_cast<quint8>(qBound(0, static_cast<int>(value + 0.5), 255));
+    }
+}
+
+void ImageAdjuster::rebuildToneTable(int brightnessValue, int gammaValue) {
+    buildToneCurve(brightnessValue, gammaValue, toneTable);
+    toneBrightness = brightnessValue;
+    toneGamma = gammaValue;
+}
+
+void ImageAdjuster::rebuildTiles(int height) {
+    const int threads = qMax(1, QThread::idealThreadCount());
+    const int tileRows = qMax(kMinTileRows, (height + threads * kTilesPerThread - 1) / (threads * kTilesPerThread));
+
+    tiles.clear();
+    for (int first = 0; first < height; first += tileRows) {
+        tiles.push_back({first, qMin(first + tileRows, height)});
+    }
+}
+
+void ImageAdjuster::apply(FrameBuffer &frame) {
+    const int brightnessValue = brightness.load(std::memory_order_relaxed);
+    const int gammaValue = gamma.load(std::memory_order_relaxed);
+    const int sharpnessValue = sharpness.load(std::memory_order_relaxed);
+    const int denoiseValue = denoise.load(std::memory_order_relaxed);
+
+    const bool tone = !toneInDecode.load(std::memory_order_relaxed)
+        && (brightnessValue != kNeutralBrightness || gammaValue != kNeutralGamma);
+    if (!tone && sharpnessValue == 0 && denoiseValue == 0) {
+        return;
+    }
+
+    if (tiles.empty() || tiles.back().end != frame.height()) {
+        rebuildTiles(frame.height());
+    }
+
+    if (tone) {
+        if (brightnessValue != toneBrightness || gammaValue != toneGamma) {
+            rebuildToneTable(brightnessValue, gammaValue);
+        }
+        const int bytes = frame.width() * 3;
+        QtConcurrent::blockingMap(tiles, [this, &frame, bytes](const Tile &tile) {
+            for (int y = tile.first; y < tile.end; ++y) {
+                if (isCopiedRow(frame, y)) {
+                    continue;
+                }
+                quint8 *row = frame.scanLine(y);
+                for (int i = 0; i < bytes; ++i) {
+                    row[i] = toneTable[row[i]];
+                }
+            }
+        });
+    }
+
+    // Denoise before sharpening so the unsharp mask does not amplify noise
+    if (denoiseValue > 0) {
+        blurMix(frame, 1, denoiseValue * 64 / 100);       // Up to a full 3x3 box blur
+    }
+    if (sharpnessValue > 0) {
+        blurMix(frame, 2, -(sharpnessValue * 128 / 100));  // Up to twice the detail added back
+    }
+}
+
+void ImageAdjuster::blurMix(FrameBuffer &frame, int centreWeight, int mix) {
+    const int height = frame.height();
+    const int bytes = frame.width() * 3;
+    sums.resize(static_cast<size_t>(height) * bytes);
+
+    // Every horizontal pass must finish before any row is written in place
+    QtConcurrent::blockingMap(tiles, [this, &frame, bytes, centreWeight](const Tile &tile) {
+        for (int y = tile.first; y < tile.end; ++y) {
+            horizontalPass(frame.constScanLine(y), sums.data() + static_cast<size_t>(y) * bytes, bytes, centreWeight);
+        }
+    });
+
+    QtConcurrent::blockingMap(tiles, [this, &frame, height, bytes, centreWeight, mix](const Tile &tile) {
+        for (int y = tile.first; y < tile.end; ++y) {
+            if (isCopiedRow(frame, y)) {
+                continue;
+            }
+            const quint16 *centre = sums.data() + static_cast<size_t>(y) * bytes;
+            const quint16 *above = y > 0 ? centre - bytes : centre;
+            const quint16 *below = y + 1 < height ? centre + bytes : centre;
+            verticalMix(above, centre, below, frame.constScanLine(y), frame.scanLine(y), bytes, centreWeight, mix);
+        }
+    });
+}
+
+void ImageAdjuster::horizontalPass(const quint8 *row, quint16 *sums, int bytes, int centreWeight) {
+    if (bytes < 6) {
+        for (int i = 0; i < bytes; ++i) {
+            sums[i] = static_cast<quint16>(row[i] * (centreWeight + 2));
+        }
+        return;
+    }
+
+    // First pixel: its left neighbour is itself
+    for (int i = 0; i < 3; ++i) {
+        sums[i] = static_cast<quint16>(row[i] * (centreWeight + 1) + row[i + 3]);
+    }
+
+    int i = 3;
+#if defined(Q_PROCESSOR_X86_64) || defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weight = _mm_set1_epi16(static_cast<short>(centreWeight));
+    for (; i + 8 + 3 <= bytes; i += 8) {
+        __m128i left = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row + i - 3)), zero);
+        __m128i centre = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row + i)), zero);
+        __m128i right = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row + i + 3)), zero);
+        __m128i sum = _mm_add_epi16(_mm_add_epi16(left, right), _mm_mullo_epi16(centre, weight));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(sums + i), sum);
+    }
+#endif
+
+    for (; i < bytes - 3; ++i) {
+        sums[i] = static_cast<quint16>(row[i - 3] + row[i] * centreWeight + row[i + 3]);
+    }
+
+    // Last pixel: its right neighbour is itself
+    for (; i < bytes; ++i) {
+        sums[i] = static_cast<quint16>(row[i - 3] + row[i] * (centreWeight + 1));
+    }
+}
+
+void ImageAdjuster::verticalMix(const quint16 *above, const quint16 *centre, const quint16 *below,
+                                const quint8 *in, quint8 *out, int bytes, int centreWeight, int mix) {
+    const int total = (2 + centreWeight) * (2 + centreWeight);
+    const int reciprocal = reciprocalFor(centreWeight);
+    int i = 0;
+
+#if defined(Q_PROCESSOR_X86_64) || defined(__SSE2__) || defined(_M_X64)
+    // The weighted sum stays below 4096 and (blur - in) * mix within +-32640,
+    // so every step fits 16-bit lanes
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weight = _mm_set1_epi16(static_cast<short>(centreWeight));
+    const __m128i half = _mm_set1_epi16(static_cast<short>(total / 2));
+    const __m128i recip = _mm_set1_epi16(static_cast<short>(reciprocal));
+    const __m128i amount = _mm_set1_epi16(static_cast<short>(mix));
+    const __m128i round = _mm_set1_epi16(32);
+    for (; i + 8 <= bytes; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(above + i));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(centre + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(below + i));
+        __m128i sum = _mm_add_epi16(_mm_add_epi16(a, b), _mm_add_epi16(_mm_mullo_epi16(c, weight), half));
+        __m128i blur = _mm_mulhi_epu16(sum, recip);
+
+        __m128i pixel = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i)), zero);
+        __m128i delta = _mm_mullo_epi16(_mm_sub_epi16(blur, pixel), amount);
+        __m128i result = _mm_add_epi16(pixel, _mm_srai_epi16(_mm_add_epi16(delta, round), 6));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(result, result));
+    }
+#endif
+
+    for (; i < bytes; ++i) {
+        const int sum = above[i] + centre[i] * centreWeight + below[i] + total / 2;
+        const int blur = (sum * reciprocal) >> 16;
+        const int delta = (blur - in[i]) * mix;
+        out[i] = static_cast<quint8>(qBound(0, in[i] + ((delta + 32) >> 6), 255));
+    }
+}
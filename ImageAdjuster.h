@@ -0,0 +1,81 @@
+#ifndef IMAGE_ADJUSTER_H
+#define IMAGE_ADJUSTER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
+class FrameBuffer;
+
+// Brightness, gamma, sharpness and denoise from the ControlUI sliders,
+// applied in place to a reassembled frame before it is published, so display,
+// recording and snapshots all see the adjusted image.
+//   - brightness and gamma: one 256-entry lookup table per frame
+//   - denoise: 3x3 box blur mixed into the image by the slider amount
+//   - sharpness: unsharp mask against a 3x3 binomial blur
+// Both filters are separable, with SSE2 inner loops, and every stage runs
+// over row tiles on the global thread pool. Stages at their neutral value are
+// skipped. Rows concealment copied from the previous (already adjusted)
+// frame are left alone so they are not adjusted twice.
+class ImageAdjuster {
+public:
+    ImageAdjuster();
+
+    // Slider values as ControlUI reports them; safe to call from any thread
+    void setBrightness(int value);  // 0..100, 50 leaves the image unchanged
+    void setGamma(int value);       // -100..100, 0 leaves the image unchanged
+    void setSharpness(int value);   // 0..100
+    void setDenoise(int value);     // 0..100
+
+    // True when every stage is at its neutral value
+    bool isNeutral() const;
+
+    // How many rows above and below a changed row the filters can change
+    int rowReach() const;
+
+    // Adjust frame in place (writer thread, before publishing)
+    void apply(FrameBuffer &frame);
+
+    // Brightness and gamma curve for one 8-bit channel, shared with the
+    // fused RGB565 tone table
+    static void buildToneCurve(int brightnessValue, int gammaValue, quint8 curve[256]);
+
+    // Leave brightness and gamma to the decoder (Rgb565ToneTable); only the
+    // filters run here then
+    void setToneInDecode(bool enabled);
+
+    // Horizontal 3-tap sum of an RGB888 row, [1 centreWeight 1] per channel
+    // with the edge pixels repeated. Vectorized with SSE2 where available.
+    static void horizontalPass(const quint8 *row, quint16 *sums, int bytes, int centreWeight);
+
+    // out = in + (blur - in) * mix / 64, where blur is the vertical
+    // [1 centreWeight 1] sum of three horizontal passes, normalised.
+    // Vectorized with SSE2 where available.
+    static void verticalMix(const quint16 *above, const quint16 *centre, const quint16 *below,
+                            const quint8 *in, quint8 *out, int bytes, int centreWeight, int mix);
+
+private:
+    struct Tile {
+        int first;
+        int end;
+    };
+
+    void rebuildTiles(int height);
+    void rebuildToneTable(int brightnessValue, int gammaValue);
+    void blurMix(FrameBuffer &frame, int centreWeight, int mix);
+
+    std::atomic<int> brightness;
+    std::atomic<int> gamma;
+    std::atomic<int> sharpness;
+    std::atomic<int> denoise;
+    std::atomic<bool> toneInDecode;
+
+    // Writer thread only
+    int toneBrightness;
+    int toneGamma;
+    quint8 toneTable[256];
+    std::vector<Tile> tiles;
+    std::vector<quint16> sums;  // Horizontal pass of the whole frame
+};
+
+#endif // IMAGE_ADJUSTER_H
@@ -0,0 +1,71 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: MetricsLog.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the rolling metrics file.
+Periodic pipeline snapshots are appended as JSON
+lines and the file is rotated by size, so a
+headless receiver keeps a bounded history of loss
+counters and latencies.
+===================================================
+*/
+
+#include "MetricsLog.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QDebug>
+
+MetricsLog::MetricsLog()
+    : maxBytes(0),
+      maxFiles(1) {
+}
+
+bool MetricsLog::open(const QString &path, qint64 limitBytes, int limitFiles) {
+    maxBytes = qMax<qint64>(limitBytes, 4096);
+    maxFiles = qMax(limitFiles, 1);
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Failed to open metrics file" << path << file.errorString();
+        return false;
+    }
+
+    qDebug() << "Writing pipeline metrics to" << path;
+    return true;
+}
+
+void MetricsLog::append(const MetricsSnapshot &snapshot) {
+    if (!file.isOpen()) {
+        return;
+    }
+
+    file.write(QJsonDocument(snapshot.toJson()).toJson(QJsonDocument::Compact));
+    file.write("\n");
+    file.flush();
+
+    if (file.size() >= maxBytes) {
+        rotate();
+    }
+}
+
+void MetricsLog::rotate() {
+    const QString path = file.fileName();
+    file.close();
+
+    // path.N-1 -> path.N, ..., path -> path.1; the oldest falls off the end
+    QFile::remove(QString("%1.%2").arg(path).arg(maxFiles));
+    for (int i = maxFiles - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2").arg(path).arg(i), QString("%1.%2").arg(path).arg(i + 1));
+    }
+    QFile::rename(path, path + ".1");
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Failed to reopen metrics file" << path << file.errorString();
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef METRICS_LOG_H
+#define METRICS_LOG_H
+
+#include <QFile>
+#include <QString>
+#include "PipelineMetrics.h"
+
+// Rolling metrics file for headless analysis: one JSON object per line,
+// rotated to path.1 ... path.N once the current file exceeds maxBytes.
+class MetricsLog {
+public:
+    MetricsLog();
+
+    bool open(const QString &path, qint64 maxBytes, int maxFiles);
+    bool isOpen() const { return file.isOpen(); }
+
+    // Append snapshot as one line and rotate if the file is full
+    void append(const MetricsSnapshot &snapshot);
+
+private:
+    void rotate();
+
+    QFile file;
+    qint64 maxBytes;
+    int maxFiles;
+};
+
+#endif // METRICS_LOG_H
@@ -0,0 +1,180 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: ObjectTracker.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the ObjectTracker class, which
+keeps detection boxes moving between inference
+results. Detections are associated with existing
+tracks by greedy IoU matching, and every track's
+position is filtered and extrapolated with a
+constant-velocity model.
+===================================================
+*/
+
+#include "ObjectTracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Alpha-beta gains: how far a matched detection pulls the position and the
+// velocity towards it
+const float kPositionGain = 0.6f;
+const float kVelocityGain = 0.3f;
+// Box size follows detections without a velocity of its own
+const float kSizeGain = 0.5f;
+}
+
+ObjectTracker::ObjectTracker(float iouThreshold, int maxMisses, int maxExtrapolation)
+    : iouThreshold(iouThreshold),
+      maxMisses(maxMisses),
+      maxExtrapolation(maxExtrapolation),
+      nextId(1) {
+}
+
+float ObjectTracker::iou(float ax, float ay, float aw, float ah, float bx, float by, float bw, float bh) {
+    if (aw <= 0.0f || ah <= 0.0f || bw <= 0.0f || bh <= 0.0f) {
+        return 0.0f;
+    }
+    const float ix = std::min(ax + aw, bx + bw) - std::max(ax, bx);
+    const float iy = std::min(ay + ah, by + bh) - std::max(ay, by);
+    if (ix <= 0.0f || iy <= 0.0f) {
+        return 0.0f;
+    }
+    const float intersection = ix * iy;
+    return intersection / (aw * ah + bw * bh - intersection);
+}
+
+void ObjectTracker::clear() {
+    tracks.clear();
+    predicted.clear();
+}
+
+void ObjectTracker::update(const DetectionResult &result) {
+    // Boxes from another geometry cannot continue the old tracks
+    if (result.frameSize != size) {
+        clear();
+        size = result.frameSize;
+    }
+
+    const std::vector<Detection> &detections = result.detections;
+
+    // Move every track to the result's frame before comparing
+    for (Track &track : tracks) {
+        if (result.sequence > track.sequence) {
+            const float frames = static_cast<float>(std::min<quint64>(result.sequence - track.sequence, maxExtrapolation));
+            track.cx += track.vx * frames;
+            track.cy += track.vy * frames;
+        }
+    }
+
+    // Every overlapping pair, best first
+    candidates.clear();
+    for (int t = 0; t < static_cast<int>(tracks.size()); ++t) {
+        const Track &track = tracks[t];
+        for (int d = 0; d < static_cast<int>(detections.size()); ++d) {
+            const QRect &box = detections[d].box;
+            const float overlap = iou(track.cx - track.w / 2, track.cy - track.h / 2, track.w, track.h,
+                                      box.x(), box.y(), box.width(), box.height());
+            if (overlap >= iouThreshold) {
+                candidates.push_back({ overlap, t, d });
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.overlap > b.overlap;
+    });
+
+    trackMatched.assign(tracks.size(), 0);
+    detectionMatched.assign(detections.size(), 0);
+    for (const Candidate &candidate : candidates) {
+        if (trackMatched[candidate.track] || detectionMatched[candidate.detection]) {
+            continue;
+        }
+        trackMatched[candidate.track] = 1;
+        detectionMatched[candidate.detection] = 1;
+
+        Track &track = tracks[candidate.track];
+        const Detection &detection = detections[candidate.detection];
+        const float cx = detection.box.x() + detection.box.width() / 2.0f;
+        const float cy = detection.box.y() + detection.box.height() / 2.0f;
+        const float frames = result.sequence > track.sequence ? static_cast<float>(result.sequence - track.sequence) : 1.0f;
+
+        // The position was already predicted to this frame; the residual
+        // corrects both position and velocity
+        const float dx = cx - track.cx;
+        const float dy = cy - track.cy;
+        track.cx += kPositionGain * dx;
+        track.cy += kPositionGain * dy;
+        track.vx += kVelocityGain * dx / frames;
+        track.vy += kVelocityGain * dy / frames;
+        track.w += kSizeGain * (detection.box.width() - track.w);
+        track.h += kSizeGain * (detection.box.height() - track.h);
+        track.score = detection.score;
+        track.misses = 0;
+    }
+
+    // Unmatched tracks coast on their velocity until they miss too often
+    for (int t = static_cast<int>(tracks.size()) - 1; t >= 0; --t) {
+        if (!trackMatched[t] && ++tracks[t].misses > maxMisses) {
+            tracks.erase(tracks.begin() + t);
+        }
+    }
+    for (Track &track : tracks) {
+        track.sequence = result.sequence;
+    }
+
+    // Unmatched detections start new tracks at rest
+    for (int d = 0; d < static_cast<int>(detections.size()); ++d) {
+        if (detectionMatched[d]) {
+            continue;
+        }
+        const QRect &box = detections[d].box;
+        Track track;
+        track.id = nextId++;
+        track.cx = box.x() + box.width() / 2.0f;
+        track.cy = box.y() + box.height() / 2.0f;
+        track.w = box.width();
+        track.h = box.height();
+        track.vx = 0.0f;
+        track.vy = 0.0f;
+        track.score = detections[d].score;
+        track.sequence = result.sequence;
+        track.misses = 0;
+        tracks.push_back(track);
+    }
+}
+
+const std::vector<TrackedObject> &ObjectTracker::predict(quint64 sequence, const QSize &frameSize) {
+    predicted.clear();
+    if (frameSize != size) {
+        return predicted;
+    }
+
+    for (const Track &track : tracks) {
+        // Frames older than the track's state are shown where it was then
+        const float frames = sequence > track.sequence
+            ? static_cast<float>(std::min<quint64>(sequence - track.sequence, maxExtrapolation))
+            : 0.0f;
+        const float cx = track.cx + track.vx * frames;
+        const float cy = track.cy + track.vy * frames;
+
+        const int x1 = qBound(0, static_cast<int>(std::lround(cx - track.w / 2)), size.width());
+        const int y1 = qBound(0, static_cast<int>(std::lround(cy - track.h / 2)), size.height());
+        const int x2 = qBound(0, static_cast<int>(std::lround(cx + track.w / 2)), size.width());
+        const int y2 = qBound(0, static_cast<int>(std::lround(cy + track.h / 2)), size.height());
+        if (x2 <= x1 || y2 <= y1) {
+            continue;  // Coasted out of the frame
+        }
+
+        TrackedObject object;
+        object.id = track.id;
+        object.box = QRect(x1, y1, x2 - x1, y2 - y1);
+        object.score = track.score;
+        predicted.push_back(object);
+    }
+    return predicted;
+}
@@ -0,0 +1,76 @@
+#ifndef OBJECT_TRACKER_H
+#define OBJECT_TRACKER_H
+
+#include <QtGlobal>
+#include <QRect>
+#include <QSize>
+#include <vector>
+#include "YoloProcessor.h"
+
+// A tracked object's box predicted for one displayed frame
+struct TrackedObject {
+    int id = 0;          // Stable for the life of the track
+    QRect box;           // Frame pixel coordinates
+    float score = 0.0f;  // Score of the last matched detection
+};
+
+// Carries detections between inference results so the overlay moves with
+// every displayed frame. Detections are matched to tracks greedily by IoU;
+// each track runs a constant-velocity alpha-beta filter in frame sequence
+// units, so positions can be predicted for any later frame. Tracks that go
+// unmatched for too many results are dropped. Only the GUI thread uses a
+// tracker.
+class ObjectTracker {
+public:
+    // iouThreshold: least overlap for a detection to continue a track
+    // maxMisses: results a track may go unmatched before it is dropped
+    // maxExtrapolation: frames a box may be moved past its last detection
+    explicit ObjectTracker(float iouThreshold = 0.3f, int maxMisses = 3, int maxExtrapolation = 30);
+
+    // Correct the tracks with an inference result; results must arrive in
+    // frame order
+    void update(const DetectionResult &result);
+
+    // Boxes of the live tracks predicted for the frame with this sequence
+    // and size; empty when the size differs from the detections'
+    const std::vector<TrackedObject> &predict(quint64 sequence, const QSize &frameSize);
+
+    void clear();
+
+    int trackCount() const { return static_cast<int>(tracks.size()); }
+
+    // Intersection over union of two boxes, 0 when either is empty
+    static float iou(float ax, float ay, float aw, float ah, float bx, float by, float bw, float bh);
+
+private:
+    // Box centre and size with the centre's velocity per frame
+    struct Track {
+        int id;
+        float cx, cy, w, h;
+        float vx, vy;
+        float score;
+        quint64 sequence;  // Frame the state refers to
+        int misses;
+    };
+
+    struct Candidate {
+        float overlap;
+        int track;
+        int detection;
+    };
+
+    float iouThreshold;
+    int maxMisses;
+    int maxExtrapolation;
+    int nextId;
+    QSize size;
+    std::vector<Track> tracks;
+
+    // Scratch reused between calls
+    std::vector<Candidate> candidates;
+    std::vector<char> trackMatched;
+    std::vector<char> detectionMatched;
+    std::vector<TrackedObject> predicted;
+};
+
+#endif // OBJECT_TRACKER_H
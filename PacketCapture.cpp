@@ -0,0 +1,189 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: PacketCapture.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the built-in raw packet
+capture that replaces the external tshark process.
+Datagrams already sitting in the packet ring are
+appended, with a length prefix and receive
+timestamp, to preallocated memory-mapped segment
+files that rotate within a fixed disk budget.
+===================================================
+*/
+
+#include "PacketCapture.h"
+#include <QDir>
+#include <QDebug>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+using namespace PacketCaptureFormat;
+
+PacketCapture::PacketCapture()
+    : segmentSize(0),
+      segmentCount(0),
+      address(0),
+      port(0),
+      mapped(nullptr),
+      writeOffset(0),
+      segmentIndex(0),
+      nextSequence(0),
+      packets(0),
+      bytes(0) {
+}
+
+PacketCapture::~PacketCapture() {
+    close();
+}
+
+bool PacketCapture::open(const QString &directory, qint64 segmentBytes, int maxSegments,
+                         quint32 destinationAddress, quint16 destinationPort) {
+    close();
+
+    QDir dir(directory);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qWarning() << "Failed to create capture directory:" << directory;
+        return false;
+    }
+
+    captureDirectory = dir.absolutePath();
+    // Room for the header and at least one full-size record
+    segmentSize = qMax(segmentBytes, static_cast<qint64>(sizeof(CaptureSegmentHeader)) + recordSize(PacketSlot::Capacity));
+    segmentCount = qMax(maxSegments, 1);
+    address = destinationAddress;
+    port = destinationPort;
+    packets = 0;
+    bytes = 0;
+    segmentIndex = 0;
+    nextSequence = 0;
+
+    emptyOldSegments();
+    if (!openSegment(0)) {
+        return false;
+    }
+
+    qDebug() << "Capturing packets to" << captureDirectory << "in" << segmentCount
+             << "segments of" << segmentSize / (1024 * 1024) << "MB";
+    return true;
+}
+
+void PacketCapture::close() {
+    closeSegment();
+}
+
+void PacketCapture::emptyOldSegments() {
+    // Rotation reuses file names, so a new capture numbers its segments from 0
+    // again. Old segments keep their files but lose their records; otherwise
+    // their higher or lower sequence numbers would interleave them with ours.
+    const QStringList names = QDir(captureDirectory).entryList(QStringList() << "capture_*.udpcap", QDir::Files);
+    for (const QString &name : names) {
+        QFile old(captureDirectory + "/" + name);
+        CaptureSegmentHeader segment;
+        if (!old.open(QIODevice::ReadWrite)
+            || old.read(reinterpret_cast<char *>(&segment), sizeof(segment)) != sizeof(segment)
+            || memcmp(segment.magic, Magic, sizeof(Magic)) != 0) {
+            continue;
+        }
+
+        segment.dataEnd = sizeof(CaptureSegmentHeader);
+        segment.records = 0;
+        if (!old.seek(0) || old.write(reinterpret_cast<const char *>(&segment), sizeof(segment)) != sizeof(segment)) {
+            qWarning() << "Failed to empty old capture segment" << old.fileName() << old.errorString();
+        }
+    }
+}
+
+bool PacketCapture::openSegment(int index) {
+    closeSegment();
+
+    segmentIndex = index;
+    file.setFileName(QString("%1/capture_%2.udpcap").arg(captureDirectory).arg(index, 2, 10, QChar('0')));
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Failed to open capture segment" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    // Reserve the whole segment up front so appends never extend the file
+    if (file.size() != segmentSize && !file.resize(segmentSize)) {
+        qWarning() << "Failed to size capture segment" << file.fileName() << file.errorString();
+        file.close();
+        return false;
+    }
+#ifdef Q_OS_LINUX
+    posix_fallocate(file.handle(), 0, segmentSize);
+#endif
+
+    mapped = file.map(0, segmentSize);
+    if (!mapped) {
+        qWarning() << "Failed to map capture segment" << file.fileName() << file.errorString();
+        file.close();
+        return false;
+    }
+
+    CaptureSegmentHeader *segment = header();
+    memset(segment, 0, sizeof(CaptureSegmentHeader));
+    memcpy(segment->magic, Magic, sizeof(Magic));
+    segment->version = Version;
+    segment->headerSize = sizeof(CaptureSegmentHeader);
+    segment->sequence = nextSequence++;
+    segment->capacity = static_cast<quint64>(segmentSize);
+    segment->dataEnd = sizeof(CaptureSegmentHeader);
+    segment->destinationAddress = address;
+    segment->destinationPort = port;
+
+    writeOffset = sizeof(CaptureSegmentHeader);
+    return true;
+}
+
+void PacketCapture::closeSegment() {
+    if (mapped) {
+        file.unmap(mapped);
+        mapped = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+}
+
+void PacketCapture::append(const PacketSlot &slot) {
+    if (!mapped || slot.size <= 0) {
+        return;
+    }
+
+    const quint32 length = static_cast<quint32>(slot.size);
+    const qint64 size = recordSize(length);
+    if (writeOffset + size > segmentSize) {
+        // Segment full: continue in the next file, overwriting the oldest
+        if (!openSegment((segmentIndex + 1) % segmentCount)) {
+            return;
+        }
+    }
+
+    CaptureRecordHeader record;
+    record.length = length;
+    record.sourceAddress = slot.sourceAddress;
+    record.sourcePort = slot.sourcePort;
+    record.reserved = 0;
+    record.reserved2 = 0;
+    record.timestampNs = slot.timestampNs;
+
+    uchar *out = mapped + writeOffset;
+    memcpy(out, &record, sizeof(record));
+    memcpy(out + sizeof(record), slot.data, length);
+
+    // Publish the record only once it is fully written
+    writeOffset += size;
+    CaptureSegmentHeader *segment = header();
+    segment->records++;
+    segment->dataEnd = static_cast<quint64>(writeOffset);
+
+    packets++;
+    bytes += length;
+}
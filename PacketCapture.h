@@ -0,0 +1,63 @@
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#include <QtGlobal>
+#include <QFile>
+#include <QString>
+#include "PacketCaptureFormat.h"
+#include "PacketSlot.h"
+
+// Appends every received datagram to preallocated, memory-mapped segment
+// files (see PacketCaptureFormat.h). Segments rotate round-robin over a fixed
+// number of files, so capture never uses more than
+// segmentBytes * maxSegments of disk. Owned by the packet drain thread: the
+// only copy is from the ring slot straight into the mapped file.
+class PacketCapture {
+public:
+    PacketCapture();
+    ~PacketCapture();
+
+    // Create or reuse capture_NN.udpcap files in directory and map the first.
+    // Segments left by an earlier capture are emptied first, so readers never
+    // merge their packets into this one.
+    bool open(const QString &directory, qint64 segmentBytes, int maxSegments,
+              quint32 destinationAddress, quint16 destinationPort);
+
+    // Unmap the current segment, keeping everything written so far
+    void close();
+
+    bool isOpen() const { return mapped != nullptr; }
+
+    // Append one datagram, rotating to the next segment when this one is full
+    void append(const PacketSlot &slot);
+
+    quint64 capturedPackets() const { return packets; }
+    quint64 capturedBytes() const { return bytes; }
+
+private:
+    Q_DISABLE_COPY(PacketCapture)
+
+    bool openSegment(int index);
+    void emptyOldSegments();
+    void closeSegment();
+    PacketCaptureFormat::CaptureSegmentHeader *header() {
+        return reinterpret_cast<PacketCaptureFormat::CaptureSegmentHeader *>(mapped);
+    }
+
+    QString captureDirectory;
+    qint64 segmentSize;
+    int segmentCount;
+    quint32 address;
+    quint16 port;
+
+    QFile file;
+    uchar *mapped;          // Current segment, null when closed
+    qint64 writeOffset;
+    int segmentIndex;
+    quint64 nextSequence;
+
+    quint64 packets;
+    quint64 bytes;
+};
+
+#endif // PACKET_CAPTURE_H
@@ -0,0 +1,53 @@
+#ifndef PACKET_CAPTURE_FORMAT_H
+#define PACKET_CAPTURE_FORMAT_H
+
+#include <QtGlobal>
+
+// On-disk layout of raw packet capture segments, shared by the receiver and
+// the capture2pcap exporter. A segment is a preallocated file that starts
+// with a CaptureSegmentHeader, followed by records packed at 8-byte
+// alignment:
+//   [CaptureRecordHeader][payload bytes][padding to 8 bytes]
+// Only the first dataEnd bytes of a segment are valid; the rest is unused
+// preallocated space. All fields are little-endian host order.
+namespace PacketCaptureFormat {
+
+const char Magic[8] = {'U', 'D', 'P', 'C', 'A', 'P', '0', '1'};
+const quint32 Version = 1;
+const int RecordAlignment = 8;
+
+struct CaptureSegmentHeader {
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;            // sizeof(CaptureSegmentHeader)
+    quint64 sequence;              // Increases with every segment opened, orders rotated files
+    quint64 capacity;              // Preallocated size of the file
+    quint64 dataEnd;               // End of the last complete record
+    quint64 records;               // Number of complete records
+    quint32 destinationAddress;    // Address the receiver was bound to, host order
+    quint16 destinationPort;       // Port the receiver was bound to
+    quint16 reserved;
+    quint8 padding[8];
+};
+
+struct CaptureRecordHeader {
+    quint32 length;                // Payload bytes that follow
+    quint32 sourceAddress;         // Sender IPv4 address, host order
+    quint16 sourcePort;
+    quint16 reserved;
+    quint32 reserved2;
+    qint64 timestampNs;            // Receive time, nanoseconds since the Unix epoch
+};
+
+static_assert(sizeof(CaptureSegmentHeader) == 64, "capture segment header must stay 64 bytes");
+static_assert(sizeof(CaptureRecordHeader) == 24, "capture record header must stay 24 bytes");
+
+// Bytes a record with length payload bytes occupies in a segment
+inline qint64 recordSize(quint32 length) {
+    return (static_cast<qint64>(sizeof(CaptureRecordHeader)) + length + RecordAlignment - 1)
+           & ~static_cast<qint64>(RecordAlignment - 1);
+}
+
+}
+
+#endif // PACKET_CAPTURE_FORMAT_H
@@ -0,0 +1,101 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: PacketCaptureReader.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements reading of raw packet capture
+segments for the capture2pcap exporter and the
+FPGA emulator's replay mode. Segments are mapped
+read-only, validated and walked record by record in
+the order they were written.
+===================================================
+*/
+
+#include "PacketCaptureReader.h"
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cstring>
+
+using namespace PacketCaptureFormat;
+
+bool PacketCaptureReader::open(const QStringList &inputs, QStringList *warnings) {
+    segments.clear();
+
+    QStringList paths;
+    for (const QString &input : inputs) {
+        QFileInfo info(input);
+        if (info.isDir()) {
+            for (const QFileInfo &entry : QDir(input).entryInfoList(QStringList() << "*.udpcap", QDir::Files)) {
+                paths << entry.absoluteFilePath();
+            }
+        } else {
+            paths << input;
+        }
+    }
+
+    for (const QString &path : paths) {
+        Segment segment;
+        if (load(path, segment, warnings)) {
+            segments.push_back(std::move(segment));
+        }
+    }
+
+    // Rotation reuses file names, so the sequence number gives the real order
+    std::sort(segments.begin(), segments.end(), [](const Segment &a, const Segment &b) {
+        return a.header.sequence < b.header.sequence;
+    });
+    return !segments.empty();
+}
+
+bool PacketCaptureReader::load(const QString &path, Segment &segment, QStringList *warnings) {
+    segment.file.reset(new QFile(path));
+    if (!segment.file->open(QIODevice::ReadOnly)) {
+        if (warnings) *warnings << QString("Cannot open %1: %2").arg(path, segment.file->errorString());
+        return false;
+    }
+    if (segment.file->size() < static_cast<qint64>(sizeof(CaptureSegmentHeader))) {
+        if (warnings) *warnings << QString("Skipping %1: too small").arg(path);
+        return false;
+    }
+
+    segment.data = segment.file->map(0, segment.file->size());
+    if (!segment.data) {
+        if (warnings) *warnings << QString("Cannot map %1: %2").arg(path, segment.file->errorString());
+        return false;
+    }
+
+    memcpy(&segment.header, segment.data, sizeof(CaptureSegmentHeader));
+    if (memcmp(segment.header.magic, Magic, sizeof(Magic)) != 0 || segment.header.version != Version) {
+        if (warnings) *warnings << QString("Skipping %1: not a capture segment").arg(path);
+        return false;
+    }
+    if (segment.header.dataEnd > static_cast<quint64>(segment.file->size())) {
+        segment.header.dataEnd = static_cast<quint64>(segment.file->size());  // Truncated file
+    }
+    return true;
+}
+
+void PacketCaptureReader::forEachRecord(const RecordVisitor &visit) const {
+    for (const Segment &segment : segments) {
+        qint64 offset = segment.header.headerSize;
+        const qint64 end = static_cast<qint64>(segment.header.dataEnd);
+
+        while (offset + static_cast<qint64>(sizeof(CaptureRecordHeader)) <= end) {
+            CaptureRecordHeader record;
+            memcpy(&record, segment.data + offset, sizeof(record));
+            const qint64 size = recordSize(record.length);
+            if (record.length == 0 || offset + size > end) {
+                break;
+            }
+
+            if (!visit(segment.header, record, segment.data + offset + sizeof(record))) {
+                return;
+            }
+            offset += size;
+        }
+    }
+}
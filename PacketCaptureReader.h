@@ -0,0 +1,42 @@
+#ifndef PACKET_CAPTURE_READER_H
+#define PACKET_CAPTURE_READER_H
+
+#include <QtGlobal>
+#include <QFile>
+#include <QStringList>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "PacketCaptureFormat.h"
+
+// Read-only view of capture segments written by PacketCapture, used by the
+// offline tools. Segments are memory-mapped and visited in sequence order,
+// which is capture order even after the rotation reused file names.
+class PacketCaptureReader {
+public:
+    using RecordVisitor = std::function<bool(const PacketCaptureFormat::CaptureSegmentHeader &segment,
+                                             const PacketCaptureFormat::CaptureRecordHeader &record,
+                                             const uchar *payload)>;
+
+    // Map every *.udpcap file of the given directories and the given segment
+    // files; unreadable files are skipped with a warning in warnings
+    bool open(const QStringList &inputs, QStringList *warnings = nullptr);
+
+    int segmentCount() const { return static_cast<int>(segments.size()); }
+
+    // Call visit for every record in capture order until it returns false
+    void forEachRecord(const RecordVisitor &visit) const;
+
+private:
+    struct Segment {
+        std::unique_ptr<QFile> file;
+        const uchar *data = nullptr;
+        PacketCaptureFormat::CaptureSegmentHeader header;
+    };
+
+    bool load(const QString &path, Segment &segment, QStringList *warnings);
+
+    std::vector<Segment> segments;
+};
+
+#endif // PACKET_CAPTURE_READER_H
@@ -0,0 +1,54 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: PacketClassifier.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the vectorized all-bytes-equal
+test behind PacketClassifier, which recognises the
+0xAA frame start and 0xBB frame end packets directly
+on the received bytes.
+===================================================
+*/
+
+#include "PacketClassifier.h"
+
+#if defined(Q_PROCESSOR_X86)
+#include <emmintrin.h>
+#endif
+
+bool PacketClassifier::allBytesEqual(const quint8 *data, int size, quint8 value) {
+    int i = 0;
+
+#if defined(Q_PROCESSOR_X86_64) || defined(__SSE2__) || defined(_M_X64)
+    const __m128i pattern = _mm_set1_epi8(static_cast<char>(value));
+
+    // 64 bytes per step, one branch per step
+    for (; i + 64 <= size; i += 64) {
+        const __m128i *p = reinterpret_cast<const __m128i *>(data + i);
+        __m128i diff = _mm_or_si128(_mm_or_si128(_mm_xor_si128(_mm_loadu_si128(p), pattern),
+                                                 _mm_xor_si128(_mm_loadu_si128(p + 1), pattern)),
+                                    _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(p + 2), pattern),
+                                                 _mm_xor_si128(_mm_loadu_si128(p + 3), pattern)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+    }
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern)) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif
+
+    for (; i < size; ++i) {
+        if (data[i] != value) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef PACKET_CLASSIFIER_H
+#define PACKET_CLASSIFIER_H
+
+#include <QtGlobal>
+
+// Tells frame start, frame end and line packets apart by looking at the raw
+// payload (header already stripped) without allocating. Line packets are
+// almost always rejected by the first byte; only candidates whose first,
+// middle and last bytes all match a marker get the full vectorized scan.
+class PacketClassifier {
+public:
+    enum Kind {
+        LinePacket,
+        StartPacket,   // Every payload byte equals the start marker
+        EndPacket      // Every payload byte equals the end marker
+    };
+
+    static Kind classify(const quint8 *payload, int size, quint8 startMarker = 0xAA, quint8 endMarker = 0xBB) {
+        if (size <= 0) {
+            return LinePacket;
+        }
+
+        const quint8 first = payload[0];
+        if (first != startMarker && first != endMarker) {
+            return LinePacket;
+        }
+        if (payload[size - 1] != first || payload[size / 2] != first) {
+            return LinePacket;
+        }
+        if (!allBytesEqual(payload, size, first)) {
+            return LinePacket;
+        }
+        return first == startMarker ? StartPacket : EndPacket;
+    }
+
+    // True when all size bytes equal value
+    static bool allBytesEqual(const quint8 *data, int size, quint8 value);
+};
+
+#endif // PACKET_CLASSIFIER_H
@@ -0,0 +1,39 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: PacketDrainThread.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the PacketDrainThread class,
+the consumer side of the packet ring. It drains
+datagrams written by UdpReceiver in bulk and passes
+them to frame reassembly without any allocation or
+event-loop round trip.
+===================================================
+*/
+
+#include "PacketDrainThread.h"
+
+namespace {
+const int kDrainBatch = 256;   // Slots released back to the producer per drain call
+const int kIdleWaitMs = 10;    // Upper bound on a sleep when no wake-up arrives
+}
+
+PacketDrainThread::PacketDrainThread(PacketRing *ring, PacketHandler handler, QObject *parent)
+    : QThread(parent), ring(ring), handler(handler) {
+}
+
+void PacketDrainThread::requestStop() {
+    stopRequested = true;
+    ring->wakeConsumer();
+}
+
+void PacketDrainThread::run() {
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        if (ring->drain(handler, kDrainBatch) == 0) {
+            ring->waitForData(kIdleWaitMs);
+        }
+    }
+}
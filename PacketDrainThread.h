@@ -0,0 +1,30 @@
+#ifndef PACKET_DRAIN_THREAD_H
+#define PACKET_DRAIN_THREAD_H
+
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include "PacketRing.h"
+
+// Consumer thread for a PacketRing. Drains committed slots in bulk and hands
+// each one to the packet handler; sleeps on the ring when it is empty.
+class PacketDrainThread : public QThread {
+    Q_OBJECT
+public:
+    using PacketHandler = std::function<void(const PacketSlot &slot)>;
+
+    PacketDrainThread(PacketRing *ring, PacketHandler handler, QObject *parent = nullptr);
+
+    // Ask the drain loop to exit and wake it up
+    void requestStop();
+
+protected:
+    void run() override;
+
+private:
+    PacketRing *ring;
+    PacketHandler handler;
+    std::atomic<bool> stopRequested{false};
+};
+
+#endif // PACKET_DRAIN_THREAD_H
@@ -0,0 +1,152 @@
+#ifndef PACKET_RING_H
+#define PACKET_RING_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "PacketSlot.h"
+
+// Fixed-capacity single-producer/single-consumer ring of preallocated packet
+// slots. The receiver thread writes datagrams straight into free slots and
+// commits them; the reassembly thread drains committed slots in bulk. Head and
+// tail live on separate cache lines so the two threads never share one.
+class PacketRing {
+public:
+    // Capacity is rounded up to the next power of two
+    explicit PacketRing(int capacity = 4096)
+        : mask(roundUpPow2(capacity) - 1),
+          entries(mask + 1) {
+    }
+
+    int capacity() const { return static_cast<int>(mask + 1); }
+
+    // --- Producer side (receiver thread only) ---
+
+    // Reserve up to max free slots without publishing them; returns how many
+    // pointers were written to out. The slots stay private until commit().
+    int acquire(PacketSlot **out, int max) {
+        const quint64 head = producer.head.load(std::memory_order_relaxed);
+        quint64 free = entries.size() - (head - producer.cachedTail);
+        if (free < static_cast<quint64>(max)) {
+            producer.cachedTail = consumer.tail.load(std::memory_order_acquire);
+            free = entries.size() - (head - producer.cachedTail);
+        }
+
+        int count = static_cast<int>(qMin<quint64>(free, static_cast<quint64>(max)));
+        for (int i = 0; i < count; ++i) {
+            out[i] = &entries[(head + i) & mask];
+        }
+        return count;
+    }
+
+    // Publish the first count slots returned by the last acquire()
+    void commit(int count) {
+        const quint64 head = producer.head.load(std::memory_order_relaxed);
+        producer.head.store(head + count, std::memory_order_release);
+        pushed.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // Count datagrams that were discarded because the ring was full
+    void recordOverflow(int count) {
+        overflowed.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // Wake the consumer if it is sleeping in waitForData()
+    void notifyConsumer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerSleeping.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(waitMutex);
+            waitCondition.notify_one();
+        }
+    }
+
+    // --- Consumer side (reassembly thread only) ---
+
+    // Call handler(const PacketSlot &) for up to max committed slots in order,
+    // then release them back to the producer. Returns the number drained.
+    template <typename Handler>
+    int drain(Handler &&handler, int max) {
+        const quint64 tail = consumer.tail.load(std::memory_order_relaxed);
+        quint64 available = consumer.cachedHead - tail;
+        if (available == 0) {
+            consumer.cachedHead = producer.head.load(std::memory_order_acquire);
+            available = consumer.cachedHead - tail;
+            if (available == 0) {
+                return 0;
+            }
+        }
+
+        int count = static_cast<int>(qMin<quint64>(available, static_cast<quint64>(max)));
+        for (int i = 0; i < count; ++i) {
+            handler(static_cast<const PacketSlot &>(entries[(tail + i) & mask]));
+        }
+        consumer.tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Sleep until the producer commits data or timeoutMs elapses
+    bool waitForData(int timeoutMs) {
+        std::unique_lock<std::mutex> lock(waitMutex);
+        consumerSleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (isEmpty()) {
+            waitCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs));
+        }
+        consumerSleeping.store(false, std::memory_order_relaxed);
+        return !isEmpty();
+    }
+
+    // Unconditionally wake the consumer (used on shutdown)
+    void wakeConsumer() {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        waitCondition.notify_all();
+    }
+
+    bool isEmpty() const {
+        return producer.head.load(std::memory_order_acquire) == consumer.tail.load(std::memory_order_relaxed);
+    }
+
+    // --- Counters (any thread) ---
+
+    quint64 pushedCount() const { return pushed.load(std::memory_order_relaxed); }
+    quint64 overflowCount() const { return overflowed.load(std::memory_order_relaxed); }
+
+private:
+    Q_DISABLE_COPY(PacketRing)
+
+    static quint64 roundUpPow2(int value) {
+        quint64 size = 1;
+        while (size < static_cast<quint64>(qMax(value, 2))) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    struct alignas(64) ProducerIndex {
+        std::atomic<quint64> head{0};
+        quint64 cachedTail = 0;    // Producer's last view of consumer.tail
+    };
+
+    struct alignas(64) ConsumerIndex {
+        std::atomic<quint64> tail{0};
+        quint64 cachedHead = 0;    // Consumer's last view of producer.head
+    };
+
+    const quint64 mask;
+    std::vector<PacketSlot> entries;
+
+    ProducerIndex producer;
+    ConsumerIndex consumer;
+
+    alignas(64) std::atomic<quint64> pushed{0};
+    std::atomic<quint64> overflowed{0};
+
+    alignas(64) std::atomic<bool> consumerSleeping{false};
+    std::mutex waitMutex;
+    std::condition_variable waitCondition;
+};
+
+#endif // PACKET_RING_H
@@ -0,0 +1,18 @@
+#ifndef PACKET_SLOT_H
+#define PACKET_SLOT_H
+
+#include <QtGlobal>
+
+// One preallocated datagram buffer. Slots are allocated once and reused for
+// every packet, so the receive path never touches the heap.
+struct alignas(64) PacketSlot {
+    static const int Capacity = 2048;  // Largest datagram kept; longer ones are truncated
+
+    char data[Capacity];               // Raw datagram including the 4-byte header
+    qint32 size;                       // Number of valid bytes in data
+    quint16 sourcePort;                // Sender port
+    quint32 sourceAddress;             // Sender IPv4 address, host byte order
+    qint64 timestampNs;                // Receive time, nanoseconds since the Unix epoch
+};
+
+#endif // PACKET_SLOT_H
@@ -0,0 +1,134 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: PipelineMetrics.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the lock-free pipeline
+instrumentation: power-of-two latency histograms
+with interval percentiles, and the JSON form of the
+per-second metrics snapshot shown in the control
+panel and written to the rolling metrics file.
+===================================================
+*/
+
+#include "PipelineMetrics.h"
+#include <QDateTime>
+#include <QtAlgorithms>
+
+#ifdef Q_OS_LINUX
+#include <time.h>
+#endif
+
+namespace {
+int bucketFor(qint64 nanoseconds) {
+    if (nanoseconds <= 0) {
+        return 0;
+    }
+    int bucket = 64 - static_cast<int>(qCountLeadingZeroBits(static_cast<quint64>(nanoseconds)));
+    return qMin(bucket, LatencyHistogram::Buckets - 1);
+}
+
+// Upper edge of bucket b in microseconds
+double bucketLimitUs(int bucket) {
+    return double(quint64(1) << bucket) / 1000.0;
+}
+}
+
+void LatencyHistogram::record(qint64 nanoseconds) {
+    buckets[bucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Counts LatencyHistogram::counts() const {
+    Counts result;
+    for (int i = 0; i < Buckets; ++i) {
+        result.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+LatencySummary LatencyHistogram::summarize(const Counts &now, const Counts &before) {
+    LatencySummary summary;
+    quint64 delta[Buckets];
+    for (int i = 0; i < Buckets; ++i) {
+        delta[i] = now.buckets[i] - before.buckets[i];
+        summary.count += delta[i];
+    }
+    if (summary.count == 0) {
+        return summary;
+    }
+
+    // Report the upper edge of the bucket each percentile falls into
+    const quint64 p50 = (summary.count * 50 + 99) / 100;
+    const quint64 p90 = (summary.count * 90 + 99) / 100;
+    const quint64 p99 = (summary.count * 99 + 99) / 100;
+    quint64 seen = 0;
+    for (int i = 0; i < Buckets; ++i) {
+        if (delta[i] == 0) {
+            continue;
+        }
+        const quint64 previous = seen;
+        seen += delta[i];
+        if (previous < p50 && seen >= p50) summary.p50Us = bucketLimitUs(i);
+        if (previous < p90 && seen >= p90) summary.p90Us = bucketLimitUs(i);
+        if (previous < p99 && seen >= p99) summary.p99Us = bucketLimitUs(i);
+        summary.maxUs = bucketLimitUs(i);
+    }
+    return summary;
+}
+
+QJsonObject LatencySummary::toJson() const {
+    QJsonObject json;
+    json["count"] = static_cast<double>(count);
+    json["p50Us"] = p50Us;
+    json["p90Us"] = p90Us;
+    json["p99Us"] = p99Us;
+    json["maxUs"] = maxUs;
+    return json;
+}
+
+QJsonObject MetricsSnapshot::toJson() const {
+    QJsonObject json;
+    json["timestamp"] = QDateTime::fromMSecsSinceEpoch(timestampMs).toUTC().toString(Qt::ISODateWithMs);
+    json["intervalSeconds"] = intervalSeconds;
+    json["packetsReceived"] = static_cast<double>(packetsReceived);
+    json["ringOverflow"] = static_cast<double>(ringOverflow);
+    json["socketOverflow"] = static_cast<double>(socketOverflow);
+    json["packetsPerSecond"] = packetsPerSecond;
+    json["runtPackets"] = static_cast<double>(runtPackets);
+    json["outOfRangeLines"] = static_cast<double>(outOfRangeLines);
+    json["duplicateLines"] = static_cast<double>(duplicateLines);
+    json["lateLines"] = static_cast<double>(lateLines);
+    json["missingStartMarkers"] = static_cast<double>(missingStartMarkers);
+    json["missingEndMarkers"] = static_cast<double>(missingEndMarkers);
+    json["framesComplete"] = static_cast<double>(framesComplete);
+    json["framesIncomplete"] = static_cast<double>(framesIncomplete);
+    json["framesEmpty"] = static_cast<double>(framesEmpty);
+    json["framesNoBuffer"] = static_cast<double>(framesNoBuffer);
+    json["interpolatedRows"] = static_cast<double>(interpolatedRows);
+    json["temporalRows"] = static_cast<double>(temporalRows);
+    json["concealedRowsPerFrame"] = concealedRowsPerFrame;
+    json["framesPainted"] = static_cast<double>(framesPainted);
+    json["framesSkipped"] = static_cast<double>(framesSkipped);
+    json["rowsPacked"] = static_cast<double>(rowsPacked);
+    json["repaintedArea"] = static_cast<double>(repaintedArea);
+    json["recorderDropped"] = static_cast<double>(recorderDropped);
+    json["detectionRuns"] = static_cast<double>(detectionRuns);
+    json["detectionSkipped"] = static_cast<double>(detectionSkipped);
+    json["arrivalToPublish"] = arrivalToPublish.toJson();
+    json["publishToPaint"] = publishToPaint.toJson();
+    json["arrivalToPaint"] = arrivalToPaint.toJson();
+    return json;
+}
+
+qint64 PipelineMetrics::wallClockNs() {
+#ifdef Q_OS_LINUX
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<qint64>(now.tv_sec) * 1000000000 + now.tv_nsec;
+#else
+    return QDateTime::currentMSecsSinceEpoch() * 1000000;
+#endif
+}
@@ -0,0 +1,115 @@
+#ifndef PIPELINE_METRICS_H
+#define PIPELINE_METRICS_H
+
+#include <QtGlobal>
+#include <QJsonObject>
+#include <QMetaType>
+#include <atomic>
+
+// Event counter written by one thread and read by any. Increments are a
+// relaxed load and store rather than a locked read-modify-write, so counting
+// on the packet path costs the same as a plain integer.
+class MetricCounter {
+public:
+    void operator++(int) { add(1); }
+    void operator+=(quint64 amount) { add(amount); }
+    operator quint64() const { return value(); }
+
+    void add(quint64 amount) {
+        count.store(count.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    quint64 value() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> count{0};
+};
+
+// Percentiles of one latency histogram over a reporting interval
+struct LatencySummary {
+    quint64 count = 0;
+    double p50Us = 0.0;
+    double p90Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;     // Upper edge of the highest non-empty bucket
+
+    QJsonObject toJson() const;
+};
+
+// Lock-free latency histogram with power-of-two nanosecond buckets: bucket b
+// holds samples in [2^(b-1), 2^b) ns. Recording is one relaxed increment;
+// readers take cumulative snapshots and diff them per interval.
+class LatencyHistogram {
+public:
+    static const int Buckets = 40;  // Up to ~9 minutes
+
+    struct Counts {
+        quint64 buckets[Buckets] = {};
+    };
+
+    void record(qint64 nanoseconds);
+
+    // Cumulative counts since construction
+    Counts counts() const;
+
+    // Percentiles of the samples recorded between two snapshots
+    static LatencySummary summarize(const Counts &now, const Counts &before);
+
+private:
+    std::atomic<quint64> buckets[Buckets] = {};
+};
+
+// One reporting interval of pipeline health, assembled once per second on
+// the GUI thread. Counts are totals since start unless noted otherwise.
+struct MetricsSnapshot {
+    qint64 timestampMs = 0;           // Wall clock at the end of the interval
+    double intervalSeconds = 0.0;
+
+    // Receive
+    quint64 packetsReceived = 0;      // Committed to the packet ring
+    quint64 ringOverflow = 0;         // Dropped because the ring was full
+    quint64 socketOverflow = 0;       // Dropped by the kernel, socket buffer full
+    double packetsPerSecond = 0.0;    // Over this interval
+
+    // Reassembly
+    quint64 runtPackets = 0;
+    quint64 outOfRangeLines = 0;
+    quint64 duplicateLines = 0;
+    quint64 lateLines = 0;
+    quint64 missingStartMarkers = 0;
+    quint64 missingEndMarkers = 0;
+    quint64 framesComplete = 0;
+    quint64 framesIncomplete = 0;
+    quint64 framesEmpty = 0;
+    quint64 framesNoBuffer = 0;
+    quint64 interpolatedRows = 0;
+    quint64 temporalRows = 0;
+    double concealedRowsPerFrame = 0.0;  // Over this interval, incomplete frames only
+
+    // Display and recording
+    quint64 framesPainted = 0;
+    quint64 framesSkipped = 0;        // Published but replaced before the next display refresh
+    quint64 rowsPacked = 0;           // Frame rows packed for display (changed rows only, sampled when downscaled)
+    quint64 repaintedArea = 0;        // Widget pixels requested for repaint
+    quint64 recorderDropped = 0;
+
+    // Object detection
+    quint64 detectionRuns = 0;        // Inferences completed
+    quint64 detectionSkipped = 0;     // Frames that reused the last result, scene unchanged
+
+    // Latency over this interval
+    LatencySummary arrivalToPublish;  // Last packet of a frame received -> frame published
+    LatencySummary publishToPaint;    // Frame published -> first painted
+    LatencySummary arrivalToPaint;    // Last packet received -> first painted
+
+    QJsonObject toJson() const;
+};
+
+Q_DECLARE_METATYPE(MetricsSnapshot)
+
+namespace PipelineMetrics {
+// Wall-clock time in nanoseconds since the Unix epoch, the clock packet
+// receive timestamps use
+qint64 wallClockNs();
+}
+
+#endif // PIPELINE_METRICS_H
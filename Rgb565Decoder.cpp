@@ -0,0 +1,292 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: Rgb565Decoder.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the RGB565 to RGB888 line
+decoder used by frame reassembly. Each received
+line is converted as soon as it arrives, using an
+AVX2 or SSE2 kernel when the CPU supports it and a
+scalar loop otherwise.
+===================================================
+*/
+
+#include "Rgb565Decoder.h"
+
+#if defined(Q_PROCESSOR_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(Q_PROCESSOR_X86) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#define RGB565_TARGET(isa) __attribute__((target(isa)))
+#else
+#define RGB565_TARGET(isa)
+#endif
+
+// Loop bodies are inlined into both the runtime and the fixed-width entry
+// points, so the latter see a constant pixel count
+#if defined(Q_CC_GNU) || defined(Q_CC_CLANG)
+#define RGB565_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(Q_CC_MSVC)
+#define RGB565_ALWAYS_INLINE __forceinline
+#else
+#define RGB565_ALWAYS_INLINE inline
+#endif
+
+Rgb565Decoder::LineFunction Rgb565Decoder::activeFunction = Rgb565Decoder::function(Rgb565Decoder::bestKernel());
+
+namespace {
+inline void decodePixel(const quint8 *src, quint8 *dst) {
+    quint16 rgb565 = static_cast<quint16>((src[0] << 8) | src[1]);
+
+    uchar r = (rgb565 >> 11) & 0x1F;
+    uchar g = (rgb565 >> 5) & 0x3F;
+    uchar b = rgb565 & 0x1F;
+
+    dst[0] = static_cast<quint8>((r << 3) | (r >> 2));
+    dst[1] = static_cast<quint8>((g << 2) | (g >> 4));
+    dst[2] = static_cast<quint8>((b << 3) | (b >> 2));
+}
+
+RGB565_ALWAYS_INLINE void scalarLine(const quint8 *src, quint8 *dst, int pixels) {
+    for (int i = 0; i < pixels; ++i) {
+        decodePixel(src + i * 2, dst + i * 3);
+    }
+}
+
+#if defined(Q_PROCESSOR_X86)
+// Expand 8 big-endian RGB565 pixels to two vectors of 32-bit R,G,B,0 pixels
+RGB565_TARGET("sse2")
+inline void expandSse2(__m128i packed, __m128i &low, __m128i &high) {
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+
+    __m128i v = _mm_or_si128(_mm_slli_epi16(packed, 8), _mm_srli_epi16(packed, 8));  // Byte swap
+    __m128i r = _mm_srli_epi16(v, 11);
+    __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), mask6);
+    __m128i b = _mm_and_si128(v, mask5);
+
+    r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+    g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+    b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+    __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+    low = _mm_unpacklo_epi16(rg, b);
+    high = _mm_unpackhi_epi16(rg, b);
+}
+
+// Squeeze four 32-bit R,G,B,0 pixels into 12 contiguous bytes
+RGB565_TARGET("sse2")
+inline void store12Sse2(quint8 *dst, __m128i pixels) {
+    const __m128i low24 = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF);
+    const __m128i high24 = _mm_set_epi32(0x0000FFFF, static_cast<int>(0xFF000000), 0x0000FFFF, static_cast<int>(0xFF000000));
+    const __m128i firstHalf = _mm_set_epi32(0, 0, 0x0000FFFF, static_cast<int>(0xFFFFFFFF));
+
+    // Each 64-bit lane now holds 6 bytes: pixel a | pixel b << 24
+    __m128i packed = _mm_or_si128(_mm_and_si128(pixels, low24), _mm_and_si128(_mm_srli_epi64(pixels, 8), high24));
+    // Move the upper 6 bytes down next to the lower ones
+    packed = _mm_or_si128(_mm_and_si128(packed, firstHalf), _mm_andnot_si128(firstHalf, _mm_srli_si128(packed, 2)));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), packed);
+    quint32 tail = static_cast<quint32>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+    dst[8] = static_cast<quint8>(tail);
+    dst[9] = static_cast<quint8>(tail >> 8);
+    dst[10] = static_cast<quint8>(tail >> 16);
+    dst[11] = static_cast<quint8>(tail >> 24);
+}
+
+RGB565_TARGET("sse2")
+RGB565_ALWAYS_INLINE void sse2Line(const quint8 *src, quint8 *dst, int pixels) {
+    int i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m128i low, high;
+        expandSse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2)), low, high);
+        store12Sse2(dst + i * 3, low);
+        store12Sse2(dst + i * 3 + 12, high);
+    }
+    scalarLine(src + i * 2, dst + i * 3, pixels - i);
+}
+
+RGB565_TARGET("avx2")
+RGB565_ALWAYS_INLINE void avx2Line(const quint8 *src, quint8 *dst, int pixels) {
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    // Per 128-bit lane: drop the fourth byte of each 32-bit pixel
+    const __m256i compact = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    int i = 0;
+    // Every 16-byte store spills 4 bytes past its 12 useful ones, so keep two
+    // pixels of headroom before the end of the line
+    for (; i + 18 <= pixels; i += 16) {
+        __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 2));
+
+        __m256i v = _mm256_or_si256(_mm256_slli_epi16(packed, 8), _mm256_srli_epi16(packed, 8));
+        __m256i r = _mm256_srli_epi16(v, 11);
+        __m256i g = _mm256_and_si256(_mm256_srli_epi16(v, 5), mask6);
+        __m256i b = _mm256_and_si256(v, mask5);
+
+        r = _mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2));
+        g = _mm256_or_si256(_mm256_slli_epi16(g, 2), _mm256_srli_epi16(g, 4));
+        b = _mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2));
+
+        __m256i rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+        // Lane 0 holds pixels 0-3 / 4-7, lane 1 holds pixels 8-11 / 12-15
+        __m256i low = _mm256_shuffle_epi8(_mm256_unpacklo_epi16(rg, b), compact);
+        __m256i high = _mm256_shuffle_epi8(_mm256_unpackhi_epi16(rg, b), compact);
+
+        quint8 *out = dst + i * 3;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_castsi256_si128(low));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 12), _mm256_castsi256_si128(high));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 24), _mm256_extracti128_si256(low, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 36), _mm256_extracti128_si256(high, 1));
+    }
+    sse2Line(src + i * 2, dst + i * 3, pixels - i);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// Full lines of the common geometries, Pixels known at compile time
+template <int Pixels>
+void scalarFixed(const quint8 *src, quint8 *dst) {
+    scalarLine(src, dst, Pixels);
+}
+
+#if defined(Q_PROCESSOR_X86)
+template <int Pixels>
+RGB565_TARGET("sse2") void sse2Fixed(const quint8 *src, quint8 *dst) {
+    sse2Line(src, dst, Pixels);
+}
+
+template <int Pixels>
+RGB565_TARGET("avx2") void avx2Fixed(const quint8 *src, quint8 *dst) {
+    avx2Line(src, dst, Pixels);
+}
+#endif
+}
+
+void Rgb565Decoder::decodeScalar(const quint8 *src, quint8 *dst, int pixels) {
+    scalarLine(src, dst, pixels);
+}
+
+RGB565_TARGET("sse2")
+void Rgb565Decoder::decodeSse2(const quint8 *src, quint8 *dst, int pixels) {
+#if defined(Q_PROCESSOR_X86)
+    sse2Line(src, dst, pixels);
+#else
+    scalarLine(src, dst, pixels);
+#endif
+}
+
+RGB565_TARGET("avx2")
+void Rgb565Decoder::decodeAvx2(const quint8 *src, quint8 *dst, int pixels) {
+#if defined(Q_PROCESSOR_X86)
+    avx2Line(src, dst, pixels);
+#else
+    scalarLine(src, dst, pixels);
+#endif
+}
+
+bool Rgb565Decoder::isSupported(Kernel kernel) {
+    switch (kernel) {
+    case Scalar:
+        return true;
+#if defined(Q_PROCESSOR_X86)
+    case Sse2:
+#if defined(Q_PROCESSOR_X86_64) || defined(__SSE2__) || defined(_M_X64)
+        return true;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#endif
+    case Avx2:
+        return cpuHasAvx2();
+#endif
+    default:
+        return false;
+    }
+}
+
+Rgb565Decoder::Kernel Rgb565Decoder::bestKernel() {
+    if (isSupported(Avx2)) {
+        return Avx2;
+    }
+    if (isSupported(Sse2)) {
+        return Sse2;
+    }
+    return Scalar;
+}
+
+Rgb565Decoder::LineFunction Rgb565Decoder::function(Kernel kernel) {
+    if (!isSupported(kernel)) {
+        return &Rgb565Decoder::decodeScalar;
+    }
+
+    switch (kernel) {
+    case Avx2:
+        return &Rgb565Decoder::decodeAvx2;
+    case Sse2:
+        return &Rgb565Decoder::decodeSse2;
+    default:
+        return &Rgb565Decoder::decodeScalar;
+    }
+}
+
+template <int Pixels>
+Rgb565Decoder::FixedLineFunction Rgb565Decoder::fixedFunction(Kernel kernel) {
+    if (!isSupported(kernel)) {
+        return &scalarFixed<Pixels>;
+    }
+
+    switch (kernel) {
+#if defined(Q_PROCESSOR_X86)
+    case Avx2:
+        return &avx2Fixed<Pixels>;
+    case Sse2:
+        return &sse2Fixed<Pixels>;
+#endif
+    default:
+        return &scalarFixed<Pixels>;
+    }
+}
+
+template Rgb565Decoder::FixedLineFunction Rgb565Decoder::fixedFunction<400>(Kernel kernel);
+template Rgb565Decoder::FixedLineFunction Rgb565Decoder::fixedFunction<640>(Kernel kernel);
+template Rgb565Decoder::FixedLineFunction Rgb565Decoder::fixedFunction<800>(Kernel kernel);
+
+const char *Rgb565Decoder::kernelName(Kernel kernel) {
+    switch (kernel) {
+    case Avx2:
+        return "avx2";
+    case Sse2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef RGB565_DECODER_H
+#define RGB565_DECODER_H
+
+#include <QtGlobal>
+
+// Big-endian RGB565 -> packed RGB888 line conversion. The SSE2 and AVX2
+// kernels produce exactly the same bytes as the scalar reference; the best
+// one for the running CPU is picked once at startup.
+class Rgb565Decoder {
+public:
+    enum Kernel {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    typedef void (*LineFunction)(const quint8 *src, quint8 *dst, int pixels);
+    typedef void (*FixedLineFunction)(const quint8 *src, quint8 *dst);
+
+    // Decode pixels big-endian RGB565 values from src into 3 * pixels bytes at dst
+    static void decodeLine(const quint8 *src, quint8 *dst, int pixels) {
+        activeFunction(src, dst, pixels);
+    }
+
+    // Fastest kernel the CPU supports
+    static Kernel bestKernel();
+
+    // Whether kernel can run on this CPU
+    static bool isSupported(Kernel kernel);
+
+    // Function implementing kernel (falls back to Scalar when unsupported)
+    static LineFunction function(Kernel kernel);
+
+    // kernel's loop instantiated for exactly Pixels pixels, so the trip count
+    // and tail are compile-time constants. Instantiated for 400, 640 and 800.
+    template <int Pixels>
+    static FixedLineFunction fixedFunction(Kernel kernel);
+
+    static const char *kernelName(Kernel kernel);
+
+    static void decodeScalar(const quint8 *src, quint8 *dst, int pixels);
+    static void decodeSse2(const quint8 *src, quint8 *dst, int pixels);
+    static void decodeAvx2(const quint8 *src, quint8 *dst, int pixels);
+
+private:
+    static LineFunction activeFunction;
+};
+
+#endif // RGB565_DECODER_H
@@ -0,0 +1,120 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: Rgb565ToneTable.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the Rgb565ToneTable class, a
+64K-entry lookup table that fuses RGB565 decoding
+with the brightness and gamma adjustments. Tables
+are rebuilt on the thread pool and handed to the
+decoding thread through a single atomic pointer.
+===================================================
+*/
+
+#include "Rgb565ToneTable.h"
+#include "ImageAdjuster.h"
+#include "Rgb565Decoder.h"
+#include <QtConcurrent>
+#include <QThread>
+#include <cstring>
+
+namespace {
+const int kEntries = 65536;
+const int kNeutralBrightness = 50;
+const int kNeutralGamma = 0;
+}
+
+Rgb565ToneTable::Rgb565ToneTable()
+    : pending(nullptr),
+      requested(pack(kNeutralBrightness, kNeutralGamma)),
+      building(false),
+      stopping(false),
+      runningBuilds(0) {
+    quint32 *neutral = new quint32[kEntries];
+    fill(neutral, kNeutralBrightness, kNeutralGamma);
+    active = Entries(neutral);
+}
+
+Rgb565ToneTable::~Rgb565ToneTable() {
+    // A build that just cleared building may still be checking for a newer
+    // request while the next one already runs, so wait for every task rather
+    // than the last one started
+    stopping.store(true);
+    while (runningBuilds.load(std::memory_order_acquire) != 0) {
+        QThread::yieldCurrentThread();
+    }
+    delete[] pending.load();
+}
+
+void Rgb565ToneTable::fill(quint32 *entries, int brightness, int gamma) {
+    quint8 curve[256];
+    ImageAdjuster::buildToneCurve(brightness, gamma, curve);
+
+    // Decode through the scalar reference so the table matches the SIMD decoder
+    for (int value = 0; value < kEntries; ++value) {
+        const quint8 source[2] = { static_cast<quint8>(value >> 8), static_cast<quint8>(value) };
+        quint8 rgb[4] = { 0, 0, 0, 0 };
+        Rgb565Decoder::decodeScalar(source, rgb, 1);
+        rgb[0] = curve[rgb[0]];
+        rgb[1] = curve[rgb[1]];
+        rgb[2] = curve[rgb[2]];
+        std::memcpy(&entries[value], rgb, sizeof(quint32));
+    }
+}
+
+void Rgb565ToneTable::rebuild(int brightness, int gamma) {
+    requested.store(pack(brightness, gamma));
+    if (stopping.load() || building.exchange(true)) {
+        return;  // The running build picks the new settings up when it finishes
+    }
+    runningBuilds.fetch_add(1);
+    QtConcurrent::run([this]() {
+        buildRequested();
+        runningBuilds.fetch_sub(1, std::memory_order_release);  // Last access to this
+    });
+}
+
+void Rgb565ToneTable::buildRequested() {
+    for (;;) {
+        if (stopping.load()) {
+            building.store(false);
+            return;
+        }
+        const int settings = requested.load();
+        quint32 *table = new quint32[kEntries];
+        fill(table, settings >> 16, static_cast<qint16>(settings & 0xFFFF));
+
+        // A table the decoder never adopted is simply replaced
+        delete[] pending.exchange(table, std::memory_order_acq_rel);
+
+        building.store(false);
+        if (requested.load() == settings || building.exchange(true)) {
+            return;
+        }
+    }
+}
+
+void Rgb565ToneTable::refresh() {
+    if (pending.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+    // Frames still open with the previous table keep it alive
+    active = Entries(pending.exchange(nullptr, std::memory_order_acq_rel));
+}
+
+void Rgb565ToneTable::decodeLine(const quint32 *table, const quint8 *src, quint8 *dst, int pixels) {
+    if (pixels <= 0) {
+        return;
+    }
+
+    // Each 4-byte store overlaps the next pixel, which overwrites the padding
+    // byte; the last pixel is stored as exactly 3 bytes
+    int i = 0;
+    for (; i < pixels - 1; ++i, src += 2, dst += 3) {
+        std::memcpy(dst, &table[(src[0] << 8) | src[1]], sizeof(quint32));
+    }
+    std::memcpy(dst, &table[(src[0] << 8) | src[1]], 3);
+}
@@ -0,0 +1,57 @@
+#ifndef RGB565_TONE_TABLE_H
+#define RGB565_TONE_TABLE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+// Optional decoder that maps every possible RGB565 value straight to its
+// final RGB888 colour, brightness and gamma included, so decode and tone
+// mapping cost one lookup per pixel and a single pass over memory. The
+// 65536-entry table (256 KB) is rebuilt on the thread pool when a slider
+// moves; the decoding thread adopts the newest finished table between
+// frames, so no lock is ever taken on the packet path.
+class Rgb565ToneTable {
+public:
+    // One finished table; frames keep the table they were opened with alive
+    typedef std::shared_ptr<const quint32[]> Entries;
+
+    // Starts with the neutral table already in place
+    Rgb565ToneTable();
+    ~Rgb565ToneTable();
+
+    // Build a table for these settings in the background (any thread).
+    // Requests arriving while a build runs collapse into one more build.
+    void rebuild(int brightness, int gamma);
+
+    // Switch to the newest finished table, if any (decoding thread)
+    void refresh();
+
+    // Table adopted by the last refresh() (decoding thread)
+    Entries current() const { return active; }
+
+    // Decode pixels big-endian RGB565 values from src into 3 * pixels bytes at dst
+    // with the current table (decoding thread)
+    void decodeLine(const quint8 *src, quint8 *dst, int pixels) const { decodeLine(active.get(), src, dst, pixels); }
+
+    // Same with the given table's entries
+    static void decodeLine(const quint32 *entries, const quint8 *src, quint8 *dst, int pixels);
+
+    // Fill a 65536-entry table; each entry holds R, G, B, 0 in memory order
+    static void fill(quint32 *entries, int brightness, int gamma);
+
+private:
+    Q_DISABLE_COPY(Rgb565ToneTable)
+
+    static int pack(int brightness, int gamma) { return (brightness << 16) | (gamma & 0xFFFF); }
+    void buildRequested();
+
+    Entries active;                      // Decoding thread only
+    std::atomic<quint32 *> pending;      // Finished table not yet adopted
+    std::atomic<int> requested;          // Packed brightness and gamma of the newest request
+    std::atomic<bool> building;
+    std::atomic<bool> stopping;          // Set on destruction, no new builds start
+    std::atomic<int> runningBuilds;      // Pool tasks that may still touch this object
+};
+
+#endif // RGB565_TONE_TABLE_H
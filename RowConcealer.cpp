@@ -0,0 +1,115 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: RowConcealer.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements missing-row concealment for
+decoded RGB888 frames. Gaps are filled by linear
+interpolation across the whole run, computed with
+an SSE2 fixed-point blend, and long gaps fall back
+to the same rows of the previously published frame.
+===================================================
+*/
+
+#include "RowConcealer.h"
+#include "FramePool.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(Q_PROCESSOR_X86)
+#include <emmintrin.h>
+#endif
+
+void RowConcealer::blendRowsScalar(const quint8 *top, const quint8 *bottom, quint8 *dst, int bytes, int weight) {
+    const int inverse = 256 - weight;
+    for (int i = 0; i < bytes; ++i) {
+        dst[i] = static_cast<quint8>((top[i] * inverse + bottom[i] * weight + 128) >> 8);
+    }
+}
+
+void RowConcealer::blendRows(const quint8 *top, const quint8 *bottom, quint8 *dst, int bytes, int weight) {
+    int i = 0;
+
+#if defined(Q_PROCESSOR_X86_64) || defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w = _mm_set1_epi16(static_cast<short>(weight));
+    const __m128i iw = _mm_set1_epi16(static_cast<short>(256 - weight));
+    const __m128i round = _mm_set1_epi16(128);
+
+    // top * iw + bottom * w + 128 stays below 65536, so 16-bit lanes are enough
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(top + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bottom + i));
+
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), iw),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), iw),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 8);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    blendRowsScalar(top + i, bottom + i, dst + i, bytes - i, weight);
+}
+
+ConcealmentResult RowConcealer::conceal(FrameBuffer &frame, const quint8 *received, int rows, int rowBytes,
+                                        const FrameBuffer *previous, int maxInterpolatedRun) {
+    ConcealmentResult result;
+    std::fill(frame.copiedRows.begin(), frame.copiedRows.end(), 0);
+
+    int row = 0;
+    while (row < rows) {
+        if (received[row]) {
+            ++row;
+            continue;
+        }
+
+        // Missing run [first, end)
+        const int first = row;
+        while (row < rows && !received[row]) {
+            ++row;
+        }
+        const int end = row;
+        const int run = end - first;
+        result.missingRows += run;
+
+        const bool hasTop = first > 0;
+        const bool hasBottom = end < rows;
+        if (!hasTop && !hasBottom) {
+            continue;  // Nothing arrived at all
+        }
+
+        if (previous && (run > maxInterpolatedRun || !hasTop || !hasBottom)) {
+            // Long or edge gap: reuse the previous frame's rows
+            for (int i = first; i < end; ++i) {
+                memcpy(frame.scanLine(i), previous->constScanLine(i), rowBytes);
+            }
+            std::fill(frame.copiedRows.begin() + first, frame.copiedRows.begin() + end, 1);
+            result.temporalRows += run;
+        } else if (hasTop && hasBottom) {
+            // Linear interpolation across the whole gap
+            const quint8 *topLine = frame.constScanLine(first - 1);
+            const quint8 *bottomLine = frame.constScanLine(end);
+            for (int i = first; i < end; ++i) {
+                const int weight = ((i - first + 1) * 256) / (run + 1);
+                blendRows(topLine, bottomLine, frame.scanLine(i), rowBytes, weight);
+            }
+            result.interpolatedRows += run;
+        } else {
+            // Edge gap on the first frame: repeat the only neighbour
+            const quint8 *source = frame.constScanLine(hasTop ? first - 1 : end);
+            for (int i = first; i < end; ++i) {
+                memcpy(frame.scanLine(i), source, rowBytes);
+            }
+            result.interpolatedRows += run;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,40 @@
+#ifndef ROW_CONCEALER_H
+#define ROW_CONCEALER_H
+
+#include <QtGlobal>
+
+class FrameBuffer;
+
+// What happened to the missing rows of one frame
+struct ConcealmentResult {
+    int missingRows = 0;        // Rows that never arrived
+    int interpolatedRows = 0;   // Filled from the rows above and below the gap
+    int temporalRows = 0;       // Copied from the same rows of the previous frame
+};
+
+// Fills rows lost on the wire in a decoded RGB888 frame. A gap of any length
+// is filled by linear interpolation between the rows on either side of it;
+// gaps longer than maxInterpolatedRun take the co-located rows of the previous
+// frame instead, since a long vertical blend is more visible than slightly
+// stale pixels. Edge gaps with one neighbour repeat that neighbour. Rows
+// taken from the previous frame are flagged in frame.copiedRows.
+class RowConcealer {
+public:
+    // Longest gap still interpolated when a previous frame is available
+    static const int DefaultMaxInterpolatedRun = 8;
+
+    // received has one entry per row, 0 for missing rows. previous may be
+    // null (first frame) and must have the same geometry as frame otherwise.
+    static ConcealmentResult conceal(FrameBuffer &frame, const quint8 *received, int rows, int rowBytes,
+                                     const FrameBuffer *previous,
+                                     int maxInterpolatedRun = DefaultMaxInterpolatedRun);
+
+    // dst = (top * (256 - weight) + bottom * weight + 128) / 256 for every
+    // byte, weight in [0, 256]. Vectorized with SSE2 where available.
+    static void blendRows(const quint8 *top, const quint8 *bottom, quint8 *dst, int bytes, int weight);
+
+    // Reference implementation of blendRows
+    static void blendRowsScalar(const quint8 *top, const quint8 *bottom, quint8 *dst, int bytes, int weight);
+};
+
+#endif // ROW_CONCEALER_H
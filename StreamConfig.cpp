@@ -0,0 +1,296 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: StreamConfig.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file loads the stream descriptor, the width,
+height, line size, header layout and marker bytes
+of the incoming camera stream, from an INI file so
+sensors with other resolutions can be used without
+rebuilding the application, together with the list
+of camera streams to receive at the same time.
+===================================================
+*/
+
+#include "StreamConfig.h"
+#include "PacketSlot.h"
+#include <QSettings>
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+
+namespace {
+const int kMaxStreams = 16;
+
+quint8 readByte(QSettings &settings, const QString &key, quint8 fallback) {
+    bool ok = false;
+    // Base 0 accepts both "0xAA" and "170"
+    uint value = settings.value(key).toString().toUInt(&ok, 0);
+    return (ok && value <= 0xFF) ? static_cast<quint8>(value) : fallback;
+}
+
+// Geometry keys of the current group; missing keys keep the values in stream
+void readDescriptorKeys(QSettings &settings, StreamDescriptor &stream) {
+    stream.width = settings.value("width", stream.width).toInt();
+    stream.height = settings.value("height", stream.height).toInt();
+    // A new width without a line size implies two bytes per pixel
+    stream.bytesPerLine = settings.value("bytesPerLine", settings.contains("width") ? stream.width * 2 : stream.bytesPerLine).toInt();
+    stream.headerSize = settings.value("headerSize", stream.headerSize).toInt();
+    stream.frameIdOffset = settings.value("frameIdOffset", stream.frameIdOffset).toInt();
+    stream.lineIndexOffset = settings.value("lineIndexOffset", stream.lineIndexOffset).toInt();
+    stream.startMarker = readByte(settings, "startMarker", stream.startMarker);
+    stream.endMarker = readByte(settings, "endMarker", stream.endMarker);
+}
+
+// Listen keys of the current group; missing keys keep the values in network
+void readNetworkKeys(QSettings &settings, NetworkSettings &network) {
+    network.bindAddress = settings.value("bindAddress", network.bindAddress).toString();
+    network.port = static_cast<quint16>(settings.value("port", network.port).toUInt());
+    network.sourceAddress = settings.value("sourceAddress", network.sourceAddress).toString();
+    network.receiveBufferKilobytes = qBound(0, settings.value("receiveBufferKB", network.receiveBufferKilobytes).toInt(), 1024 * 1024);
+    network.forceReceiveBuffer = settings.value("forceReceiveBuffer", network.forceReceiveBuffer).toBool();
+    network.busyPollMicroseconds = qBound(0, settings.value("busyPollMicroseconds", network.busyPollMicroseconds).toInt(), 1000000);
+}
+
+// "metrics.jsonl" -> "metrics_camera2.jsonl"
+QString perStreamFile(const QString &file, const QString &name) {
+    QFileInfo info(file);
+    QString fileName = info.completeBaseName() + "_" + name;
+    if (!info.suffix().isEmpty()) {
+        fileName += "." + info.suffix();
+    }
+    return info.path() == "." ? fileName : info.path() + "/" + fileName;
+}
+}
+
+bool StreamDescriptor::isValid(QString *error) const {
+    QString reason;
+    if (width <= 0 || height <= 0 || width > 8192 || height > 8192) {
+        reason = QString("unsupported resolution %1x%2").arg(width).arg(height);
+    } else if (bytesPerLine < 2 || bytesPerLine % 2 != 0) {
+        reason = QString("bytesPerLine must be a positive even number, got %1").arg(bytesPerLine);
+    } else if (bytesPerLine < width * 2) {
+        // Lines shorter than a row would leave its right part never decoded
+        reason = QString("bytesPerLine %1 is shorter than a %2-pixel row").arg(bytesPerLine).arg(width);
+    } else if (headerSize < 4 || frameIdOffset < 0 || lineIndexOffset < 0
+               || frameIdOffset + 2 > headerSize || lineIndexOffset + 2 > headerSize) {
+        reason = QString("frame ID and line index must fit in the %1-byte header").arg(headerSize);
+    } else if (packetSize() > PacketSlot::Capacity) {
+        reason = QString("line packets of %1 bytes exceed the %2-byte packet slots").arg(packetSize()).arg(PacketSlot::Capacity);
+    } else if (startMarker == endMarker) {
+        reason = "start and end markers must differ";
+    }
+
+    if (error) {
+        *error = reason;
+    }
+    return reason.isEmpty();
+}
+
+StreamDescriptor StreamDescriptor::fromSettings(QSettings &settings) {
+    StreamDescriptor stream;
+
+    settings.beginGroup("stream");
+    readDescriptorKeys(settings, stream);
+    settings.endGroup();
+
+    return stream;
+}
+
+RecordingSettings RecordingSettings::fromSettings(QSettings &settings) {
+    RecordingSettings recording;
+
+    settings.beginGroup("recording");
+    recording.queueDepth = qBound(1, settings.value("queueDepth", recording.queueDepth).toInt(), 256);
+    // "block" waits for the encoder, anything else drops frames when the queue is full
+    recording.blockWhenFull = settings.value("queuePolicy", "drop").toString() == "block";
+    settings.endGroup();
+
+    return recording;
+}
+
+CaptureSettings CaptureSettings::fromSettings(QSettings &settings) {
+    CaptureSettings capture;
+
+    settings.beginGroup("capture");
+    capture.enabled = settings.value("enabled", capture.enabled).toBool();
+    capture.directory = settings.value("directory", capture.directory).toString();
+    capture.segmentMegabytes = qBound(1, settings.value("segmentMegabytes", capture.segmentMegabytes).toInt(), 4096);
+    capture.maxSegments = qBound(1, settings.value("maxSegments", capture.maxSegments).toInt(), 100);
+    settings.endGroup();
+
+    return capture;
+}
+
+ProcessingSettings ProcessingSettings::fromSettings(QSettings &settings) {
+    ProcessingSettings processing;
+
+    settings.beginGroup("processing");
+    // "lut" fuses decode and tone mapping, anything else keeps the SIMD decoder
+    processing.toneLookupDecode = settings.value("decoder", "simd").toString() == "lut";
+    settings.endGroup();
+
+    return processing;
+}
+
+DetectionSettings DetectionSettings::fromSettings(QSettings &settings) {
+    DetectionSettings detection;
+
+    settings.beginGroup("detection");
+    detection.enabled = settings.value("enabled", detection.enabled).toBool();
+    detection.model = settings.value("model", detection.model).toString();
+    detection.inputSize = qBound(32, settings.value("inputSize", detection.inputSize).toInt(), 2048);
+    detection.scoreThreshold = qBound(0.0f, settings.value("scoreThreshold", detection.scoreThreshold).toFloat(), 1.0f);
+    detection.nmsThreshold = qBound(0.0f, settings.value("nmsThreshold", detection.nmsThreshold).toFloat(), 1.0f);
+    detection.instances = qBound(1, settings.value("instances", detection.instances).toInt(), 64);
+    detection.threadsPerInstance = qBound(0, settings.value("threadsPerInstance", detection.threadsPerInstance).toInt(), 256);
+    detection.changeThreshold = qBound(0.0f, settings.value("changeThreshold", detection.changeThreshold).toFloat(), 1.0f);
+    settings.endGroup();
+
+    return detection;
+}
+
+MetricsSettings MetricsSettings::fromSettings(QSettings &settings) {
+    MetricsSettings metrics;
+
+    settings.beginGroup("metrics");
+    metrics.enabled = settings.value("enabled", metrics.enabled).toBool();
+    metrics.file = settings.value("file", metrics.file).toString();
+    metrics.maxMegabytes = qBound(1, settings.value("maxMegabytes", metrics.maxMegabytes).toInt(), 1024);
+    metrics.maxFiles = qBound(1, settings.value("maxFiles", metrics.maxFiles).toInt(), 100);
+    settings.endGroup();
+
+    return metrics;
+}
+
+NetworkSettings NetworkSettings::fromSettings(QSettings &settings) {
+    NetworkSettings network;
+
+    settings.beginGroup("network");
+    readNetworkKeys(settings, network);
+    settings.endGroup();
+
+    return network;
+}
+
+StreamSettings StreamSettings::fromSettings(QSettings &settings) {
+    StreamSettings stream;
+    stream.descriptor = StreamDescriptor::fromSettings(settings);
+    stream.network = NetworkSettings::fromSettings(settings);
+    stream.recording = RecordingSettings::fromSettings(settings);
+    stream.capture = CaptureSettings::fromSettings(settings);
+    stream.processing = ProcessingSettings::fromSettings(settings);
+    stream.detection = DetectionSettings::fromSettings(settings);
+    stream.metrics = MetricsSettings::fromSettings(settings);
+    return stream;
+}
+
+StreamDescriptor loadStreamDescriptor(const QString &path) {
+    if (!QFileInfo::exists(path)) {
+        qDebug() << "No stream config at" << path << "- using the default 400x400 stream.";
+        return StreamDescriptor();
+    }
+
+    QSettings settings(path, QSettings::IniFormat);
+    StreamDescriptor stream = StreamDescriptor::fromSettings(settings);
+
+    QString error;
+    if (!stream.isValid(&error)) {
+        qWarning() << "Invalid stream config in" << path << ":" << error << "- using defaults.";
+        return StreamDescriptor();
+    }
+
+    qDebug() << "Stream geometry" << stream.width << "x" << stream.height
+             << "line bytes" << stream.bytesPerLine << "header" << stream.headerSize;
+    return stream;
+}
+
+StreamSettings loadStreamSettings(const QString &path) {
+    StreamSettings stream;
+    stream.descriptor = loadStreamDescriptor(path);
+    if (!QFileInfo::exists(path)) {
+        return stream;
+    }
+
+    QSettings settings(path, QSettings::IniFormat);
+    stream.network = NetworkSettings::fromSettings(settings);
+    stream.recording = RecordingSettings::fromSettings(settings);
+    stream.capture = CaptureSettings::fromSettings(settings);
+    stream.processing = ProcessingSettings::fromSettings(settings);
+    stream.detection = DetectionSettings::fromSettings(settings);
+    stream.metrics = MetricsSettings::fromSettings(settings);
+    return stream;
+}
+
+std::vector<StreamSettings> loadStreamList(const QString &path) {
+    const StreamSettings base = loadStreamSettings(path);
+    std::vector<StreamSettings> streams;
+    if (!QFileInfo::exists(path)) {
+        streams.push_back(base);
+        return streams;
+    }
+
+    QSettings settings(path, QSettings::IniFormat);
+    const int count = qBound(1, settings.value("streams/count", 1).toInt(), kMaxStreams);
+    if (count == 1) {
+        streams.push_back(base);
+        return streams;
+    }
+
+    for (int i = 1; i <= count; ++i) {
+        StreamSettings stream = base;
+        stream.name = QString("camera%1").arg(i);
+
+        settings.beginGroup(stream.name);
+        readDescriptorKeys(settings, stream.descriptor);
+        readNetworkKeys(settings, stream.network);
+        stream.detection.enabled = settings.value("detection", stream.detection.enabled).toBool();
+        settings.endGroup();
+
+        QString error;
+        if (!stream.descriptor.isValid(&error)) {
+            qWarning() << "Invalid stream config for" << stream.name << ":" << error << "- stream skipped.";
+            continue;
+        }
+
+        // Files of different streams must not overwrite each other
+        stream.capture.directory = QDir(stream.capture.directory).filePath(stream.name);
+        stream.metrics.file = perStreamFile(stream.metrics.file, stream.name);
+        streams.push_back(stream);
+    }
+
+    if (streams.empty()) {
+        qWarning() << "No valid stream in" << path << "- using the base stream.";
+        streams.push_back(base);
+        return streams;
+    }
+
+    // Streams on the same address and port join one SO_REUSEPORT group; the
+    // kernel then delivers each camera's datagrams to the socket connected to it
+    for (size_t i = 0; i < streams.size(); ++i) {
+        for (size_t j = i + 1; j < streams.size(); ++j) {
+            NetworkSettings &a = streams[i].network;
+            NetworkSettings &b = streams[j].network;
+            // The wildcard address overlaps every other one
+            const bool sameAddress = a.bindAddress == b.bindAddress
+                                     || a.bindAddress == "0.0.0.0" || b.bindAddress == "0.0.0.0";
+            if (a.port == b.port && sameAddress) {
+                a.sharedPort = true;
+                b.sharedPort = true;
+            }
+        }
+    }
+    for (const StreamSettings &stream : streams) {
+        if (stream.network.sharedPort && stream.network.sourceAddress.isEmpty()) {
+            qWarning() << stream.name << "shares port" << stream.network.port
+                       << "without a sourceAddress; the kernel will assign senders to streams arbitrarily.";
+        }
+        qDebug() << "Stream" << stream.name << stream.descriptor.width << "x" << stream.descriptor.height
+                 << "on" << stream.network.bindAddress << "port" << stream.network.port
+                 << "from" << (stream.network.sourceAddress.isEmpty() ? QString("any sender") : stream.network.sourceAddress);
+    }
+    return streams;
+}
@@ -0,0 +1,132 @@
+#ifndef STREAM_CONFIG_H
+#define STREAM_CONFIG_H
+
+#include <QtGlobal>
+#include <QString>
+#include <vector>
+
+class QSettings;
+
+// Geometry and packet layout of one camera stream. Every line packet is
+//   [headerSize bytes header][bytesPerLine bytes of big-endian RGB565]
+// with the frame ID and line index stored as big-endian 16-bit values at
+// frameIdOffset and lineIndexOffset inside the header. Start and end packets
+// carry the same header followed by a payload made only of the marker byte.
+struct StreamDescriptor {
+    int width = 400;
+    int height = 400;
+    int bytesPerLine = 800;
+    int headerSize = 4;
+    int frameIdOffset = 0;
+    int lineIndexOffset = 2;
+    quint8 startMarker = 0xAA;
+    quint8 endMarker = 0xBB;
+
+    // Pixels decoded from each line packet
+    int pixelsPerLine() const { return qMin(width, bytesPerLine / 2); }
+
+    // Largest datagram a line packet can produce
+    int packetSize() const { return headerSize + bytesPerLine; }
+
+    // Check the descriptor is usable, with a readable reason when it is not
+    bool isValid(QString *error = nullptr) const;
+
+    // Read the [stream] group; missing keys keep their defaults
+    static StreamDescriptor fromSettings(QSettings &settings);
+};
+
+// Recording queue settings from the [recording] group
+struct RecordingSettings {
+    int queueDepth = 8;          // Frames converted and waiting for the encoder
+    bool blockWhenFull = false;  // Block reassembly instead of dropping frames
+
+    static RecordingSettings fromSettings(QSettings &settings);
+};
+
+// Raw packet capture settings from the [capture] group
+struct CaptureSettings {
+    bool enabled = false;
+    QString directory = "capture";  // Relative paths are under the executable's directory
+    int segmentMegabytes = 256;     // Size of each preallocated segment file
+    int maxSegments = 4;            // Files rotated round-robin
+
+    static CaptureSettings fromSettings(QSettings &settings);
+};
+
+// How lines are decoded, from the [processing] group
+struct ProcessingSettings {
+    // Decode through a 64K-entry RGB565 -> RGB888 table with brightness and
+    // gamma baked in, instead of the SIMD decoder plus a separate tone pass
+    bool toneLookupDecode = false;
+
+    static ProcessingSettings fromSettings(QSettings &settings);
+};
+
+// Object detection settings from the [detection] group
+struct DetectionSettings {
+    bool enabled = false;
+    QString model = "yolov8n_416.onnx";  // Relative paths are under the executable's directory
+    int inputSize = 416;                 // Square network input the model was exported with
+    float scoreThreshold = 0.85f;
+    float nmsThreshold = 0.5f;
+    int instances = 1;                   // Networks running in parallel, each on its own thread
+    int threadsPerInstance = 0;          // OpenCV threads per network, 0 splits the cores evenly
+    float changeThreshold = 0.0f;        // Fraction of rows that must change before the next
+                                         // inference; below it the last result is reused
+
+    static DetectionSettings fromSettings(QSettings &settings);
+};
+
+// Periodic pipeline metrics file from the [metrics] group
+struct MetricsSettings {
+    bool enabled = false;
+    QString file = "metrics.jsonl";  // Relative paths are under the executable's directory
+    int maxMegabytes = 16;           // Rotate once the file exceeds this size
+    int maxFiles = 4;                // Rotated files kept besides the current one
+
+    static MetricsSettings fromSettings(QSettings &settings);
+};
+
+// Where the receiver listens, from the [network] group
+struct NetworkSettings {
+    QString bindAddress = "192.168.1.102";
+    quint16 port = 8080;
+    QString sourceAddress;    // Only datagrams from this sender are received, empty accepts any
+    bool sharedPort = false;  // Another stream binds the same address and port (SO_REUSEPORT)
+    int receiveBufferKilobytes = 8192;  // Kernel socket buffer (SO_RCVBUF), 0 keeps the system default
+    bool forceReceiveBuffer = false;    // SO_RCVBUFFORCE past net.core.rmem_max (needs CAP_NET_ADMIN)
+    int busyPollMicroseconds = 0;       // SO_BUSY_POLL, 0 disables it
+
+    static NetworkSettings fromSettings(QSettings &settings);
+};
+
+// Everything one camera stream is configured with
+struct StreamSettings {
+    QString name;  // "camera1", "camera2", ... when several streams run, else empty
+    StreamDescriptor descriptor;
+    NetworkSettings network;
+    RecordingSettings recording;
+    CaptureSettings capture;
+    ProcessingSettings processing;
+    DetectionSettings detection;
+    MetricsSettings metrics;
+
+    static StreamSettings fromSettings(QSettings &settings);
+};
+
+// Load the stream descriptor from an INI file, falling back to the defaults
+// (400x400, 4-byte header) when the file is missing or invalid
+StreamDescriptor loadStreamDescriptor(const QString &path);
+
+// Load every stream setting from an INI file; missing groups and keys keep
+// their defaults and an invalid descriptor falls back to the default one
+StreamSettings loadStreamSettings(const QString &path);
+
+// Load every camera stream. [streams] count=N adds a [cameraN] group per
+// stream whose geometry, network and detection keys override the base groups;
+// streams that share an address and port are marked for SO_REUSEPORT, and
+// capture and metrics files get one per stream. Streams with an invalid
+// geometry are skipped; without a [streams] group there is one unnamed stream.
+std::vector<StreamSettings> loadStreamList(const QString &path);
+
+#endif // STREAM_CONFIG_H
@@ -17,26 +17,109 @@ of UI elements.
 
 
 #include "UdpFrameProcessor.h"
+#include <QCoreApplication>
+#include <QFontMetrics>
+#include <QPaintEvent>
+#include <QShowEvent>
+
+namespace {
+// Frames being reassembled at once
+const int kReassemblyWindow = 3;
+// Window plus the published frame, the one on screen and one more reader
+const int kFramePoolSize = kReassemblyWindow + 3;
+
+// Each detector instance may hold a frame for the length of an inference
+int framePoolSize(const DetectionSettings &detection) {
+    return kFramePoolSize + (detection.enabled ? detection.instances : 0);
+}
+}
 
-UdpFrameProcessor::UdpFrameProcessor(QWidget *parent)
-    : QWidget(parent), frameCount(0), receivedLines(0), flipHorizontal(false), flipVertical(false), isRecording(false) {
-    // Initialize the image and set a black background
-    image = QImage(400, 400, QImage::Format_RGB888);
-    image.fill(Qt::black);
+UdpFrameProcessor::UdpFrameProcessor(const StreamSettings &settings, QWidget *parent)
+    : QWidget(parent), frameCount(0), concealedFrames(0), interpolatedLines(0), temporalLines(0),
+      receivedLines(0), streamName(settings.name), packetRing(4096),
+      framePool(settings.descriptor.width, settings.descriptor.height, framePoolSize(settings.detection)),
+      reassembler(settings.descriptor, &framePool, kReassemblyWindow),
+      brightness(50), gamma(0),
+      flipHorizontal(false), flipVertical(false), detector(nullptr),
+      lastPaintedSequence(0), framesPainted(0),
+      intervalPackets(0), intervalIncomplete(0), intervalConcealedRows(0) {
+    // Every pixel is painted by paintEvent, so Qt need not clear the background first
+    setAttribute(Qt::WA_OpaquePaintEvent);
 
     // Set up the FPS timer
     fpsTimer = new QTimer(this);
     connect(fpsTimer, &QTimer::timeout, this, &UdpFrameProcessor::updateFPS);
     fpsTimer->start(1000);  // Update FPS every second
+    metricsInterval.start();
+
+    // Repaint at most once per display refresh, always with the newest frame;
+    // started from showEvent, when the screen showing the widget is known
+    displayScheduler = new DisplayScheduler(&framePool, this, this);
+    displayScheduler->setRenderer([this]() { return renderNewestFrame(); });
 
     qDebug() << "UdpFrameProcessor initialized";
 
+    // Encoder thread for recording, started on demand
+    recorder = new VideoRecorder();
+    recorder->setQueueDepth(settings.recording.queueDepth);
+    recorder->setQueuePolicy(settings.recording.blockWhenFull ? VideoRecorder::BlockWhenFull : VideoRecorder::DropWhenFull);
+
+    // Brightness and gamma either come out of the decoder or are a separate pass
+    if (settings.processing.toneLookupDecode) {
+        toneTable.reset(new Rgb565ToneTable());
+        reassembler.setToneTable(toneTable.get());
+        imageAdjuster.setToneInDecode(true);
+        qDebug() << "Decoding through the RGB565 tone lookup table";
+    }
+
+    // The detector reads published frames straight from the pool
+    if (settings.detection.enabled) {
+        qRegisterMetaType<DetectionResult>("DetectionResult");
+        detector = new YoloProcessor(&framePool, settings.detection);
+        connect(detector, &YoloProcessor::detectionFinished, this, &UdpFrameProcessor::onDetectionFinished, Qt::QueuedConnection);
+    }
+
+    // Retired frames (complete or superseded) are published from the pool
+    reassembler.setFrameHandler([this](FrameReassembler::Frame &frame, bool complete) {
+        publishFrame(frame, complete);
+    });
+
+    const NetworkSettings network = settings.network;  // Copied into the receiver start lambda below
+    const CaptureSettings &capture = settings.capture;
+    if (capture.enabled) {
+        QDir base(QCoreApplication::applicationDirPath());
+        packetCapture.open(base.absoluteFilePath(capture.directory), qint64(capture.segmentMegabytes) * 1024 * 1024,
+                           capture.maxSegments, QHostAddress(network.bindAddress).toIPv4Address(), network.port);
+    }
+
+    const MetricsSettings &metrics = settings.metrics;
+    if (metrics.enabled) {
+        QDir base(QCoreApplication::applicationDirPath());
+        metricsLog.open(base.absoluteFilePath(metrics.file), qint64(metrics.maxMegabytes) * 1024 * 1024, metrics.maxFiles);
+    }
+
+    // Drain the packet ring on its own thread
+    drainThread = new PacketDrainThread(&packetRing, [this](const PacketSlot &slot) {
+        reassembler.addPacket(slot.data, slot.size, slot.timestampNs);
+        if (packetCapture.isOpen()) {
+            packetCapture.append(slot);  // Copied straight from the ring slot into the mapped segment
+        }
+    });
+    drainThread->start();
+
     // Set up UDP receiver and move to a new thread
     receiver = new UdpReceiver();
+    receiver->setPacketRing(&packetRing);
+    receiver->setSourceAddress(network.sourceAddress);
+    receiver->setPortSharing(network.sharedPort);
+    receiver->setReceiveBufferSize(network.receiveBufferKilobytes * 1024, network.forceReceiveBuffer);
+    receiver->setBusyPoll(network.busyPollMicroseconds);
     receiverThread = new QThread();
     receiver->moveToThread(receiverThread);
-    connect(receiverThread, &QThread::started, receiver, [=]() { receiver->startReceiving("192.168.1.102", 8080); });
-    connect(receiver, &UdpReceiver::newFrameData, this, &UdpFrameProcessor::processFrameData, Qt::QueuedConnection);
+    connect(receiverThread, &QThread::started, receiver, [=]() { receiver->startReceiving(network.bindAddress, network.port); });
+    connect(receiver, &UdpReceiver::batchStatsChanged, this, &UdpFrameProcessor::receiveStatsChanged, Qt::QueuedConnection);
+    connect(receiver, &UdpReceiver::ringOverflowChanged, this, &UdpFrameProcessor::ringOverflowChanged, Qt::QueuedConnection);
+    connect(receiver, &UdpReceiver::socketOverflowChanged, this, &UdpFrameProcessor::socketOverflowChanged, Qt::QueuedConnection);
     connect(receiverThread, &QThread::finished, receiver, &QObject::deleteLater);
     connect(receiverThread, &QThread::finished, receiverThread, &QObject::deleteLater);
     receiverThread->start();
@@ -47,161 +130,259 @@ UdpFrameProcessor::~UdpFrameProcessor() {
     receiverThread->wait();  // Wait for the thread to finish
     delete receiver;
 
-    if (videoWriter.isOpened()) {
-        videoWriter.release();
+    drainThread->requestStop();
+    drainThread->wait();
+    delete drainThread;
+
+    // No more frames are published; waits for a running inference
+    delete detector;
+
+    // Reassembly has stopped, so nothing is enqueued any more
+    recorder->close();
+    delete recorder;
+}
+
+void UdpFrameProcessor::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    displayScheduler->start();
+}
+
+void UdpFrameProcessor::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+
+    // The frame the scheduler rendered, so the repainted region matches it.
+    // The handle keeps reassembly from writing into it underneath us.
+    FrameHandle frame = displayedFrame.isNull() ? framePool.latest() : displayedFrame;
+    if (frame.isNull()) {
+        painter.fillRect(event->rect(), Qt::black);
+        return;
+    }
+
+    // Latency is measured on the first paint of each frame only
+    if (frame->sequence != lastPaintedSequence) {
+        lastPaintedSequence = frame->sequence;
+        framesPainted++;
+        const qint64 now = PipelineMetrics::wallClockNs();
+        publishToPaint.record(now - frame->publishNs);
+        if (frame->arrivalNs > 0) {
+            arrivalToPaint.record(now - frame->arrivalNs);
+        }
+    }
+
+    // Scaled, flipped and converted once per frame; painting is a plain blit
+    const QImage &image = displayScaler.render(*frame, size(), flipHorizontal, flipVertical);
+    const QRect target = displayScaler.placement();
+
+    // Black borders around the centred image, then only the exposed bands of it
+    const QRegion border = event->region() - QRegion(target);
+    for (const QRect &area : border) {
+        painter.fillRect(area, Qt::black);
+    }
+    const QRegion exposed = event->region() & QRegion(target);
+    for (const QRect &area : exposed) {
+        painter.drawImage(area.topLeft(), image, area.translated(-target.topLeft()));
+    }
+
+    if (detector) {
+        drawDetections(painter, target, *frame);
     }
 }
 
-void UdpFrameProcessor::writeFrameToVideo() {
-    QImage rgbFrame = image.convertToFormat(QImage::Format_RGB888);
-    cv::Mat mat(rgbFrame.height(), rgbFrame.width(), CV_8UC3, const_cast<uchar *>(rgbFrame.bits()), rgbFrame.bytesPerLine());
-    cv::Mat matBGR;
-    cv::cvtColor(mat, matBGR, cv::COLOR_RGB2BGR);
+QRegion UdpFrameProcessor::renderNewestFrame() {
+    displayedFrame = framePool.latest();
+    if (displayedFrame.isNull()) {
+        return QRegion();
+    }
 
-    if (!matBGR.empty()) {
-        videoWriter.write(matBGR);
-        qDebug() << "Frame written to video.";
-    } else {
-        qWarning() << "Frame data is empty or invalid. Skipping frame.";
+    // Only the rows that changed since the last rendered frame are converted
+    displayScaler.render(*displayedFrame, size(), flipHorizontal, flipVertical);
+
+    // The detection boxes move with every frame: repaint where they were and
+    // where they are now, on top of the rows that changed
+    QRegion region = displayScaler.changedRegion();
+    if (detector) {
+        const QRegion overlay = detectionRegion(displayScaler.placement(), *displayedFrame);
+        region += detectionOverlay;
+        region += overlay;
+        detectionOverlay = overlay;
     }
+    return region;
 }
 
-void UdpFrameProcessor::paintEvent(QPaintEvent *event) {
-    Q_UNUSED(event);
-    QPainter painter(this);
+void UdpFrameProcessor::drawDetections(QPainter &painter, const QRect &target, const FrameBuffer &frame) {
+    // Boxes are in frame pixels, extrapolated to this frame between results
+    const std::vector<TrackedObject> &objects = tracker.predict(frame.sequence, QSize(frame.width(), frame.height()));
+    if (objects.empty()) {
+        return;
+    }
 
-    // Enable anti-aliasing
-    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(Qt::red, 2));
+    painter.setBrush(Qt::NoBrush);
+    for (const TrackedObject &object : objects) {
+        const QRectF outline = detectionOutline(object.box, target, frame);
+        painter.drawRect(outline);
+        painter.drawText(outline.topLeft() + QPointF(3, -4), QString::number(object.id));
+    }
+}
 
-    // Set up scaling and drawing rectangles
-    QRect targetRect(0, 0, 800, 800);  // Target area is 800x800
-    QRect sourceRect(0, 0, image.width(), image.height());  // Original image size
+QRegion UdpFrameProcessor::detectionRegion(const QRect &target, const FrameBuffer &frame) {
+    QRegion region;
+    const QFontMetrics metrics(font());
+    for (const TrackedObject &object : tracker.predict(frame.sequence, QSize(frame.width(), frame.height()))) {
+        // The 2-pixel pen straddles the outline; the label sits above its top-left corner
+        const QRectF outline = detectionOutline(object.box, target, frame);
+        region += outline.toAlignedRect().adjusted(-2, -2, 2, 2);
+        const QPoint baseline = (outline.topLeft() + QPointF(3, -4)).toPoint();
+        region += metrics.boundingRect(QString::number(object.id)).translated(baseline).adjusted(-1, -1, 1, 1);
+    }
+    return region;
+}
 
-    // Apply transformations for flipping
-    QTransform transform;
-    if (flipHorizontal) transform.scale(-1, 1);  // Horizontal flip
-    if (flipVertical) transform.scale(1, -1);    // Vertical flip
+QRectF UdpFrameProcessor::detectionOutline(const QRect &box, const QRect &target, const FrameBuffer &frame) const {
+    const double scaleX = double(target.width()) / frame.width();
+    const double scaleY = double(target.height()) / frame.height();
+    const int x = flipHorizontal ? frame.width() - box.x() - box.width() : box.x();
+    const int y = flipVertical ? frame.height() - box.y() - box.height() : box.y();
+    return QRectF(target.x() + x * scaleX, target.y() + y * scaleY, box.width() * scaleX, box.height() * scaleY);
+}
 
-    painter.setTransform(transform);
+void UdpFrameProcessor::onDetectionFinished(const DetectionResult &result) {
+    tracker.update(result);
 
-    // Draw the image
-    painter.drawImage(targetRect, image, sourceRect);
+    // The boxes jump to the new result; only the overlay needs repainting
+    if (displayedFrame.isNull()) {
+        update();
+        return;
+    }
+    const QRegion overlay = detectionRegion(displayScaler.placement(), *displayedFrame);
+    update(detectionOverlay + overlay);
+    detectionOverlay = overlay;
 }
 
 void UdpFrameProcessor::updateFPS() {
     emit fpsChanged(frameCount);
     frameCount = 0;  // Reset frame counter
-}
 
-void UdpFrameProcessor::processFrameData(const QByteArray &data) {
-    QMetaObject::invokeMethod(this, [=]() {
-        static bool frameValid = false;                  // Whether or not valid frames are being constructed
-        static int currentLine = 0;                      // The line number currently being processed
-        static QVector<QByteArray> frameBuffer(400);     // Temporarily caches 400 lines of image data
-        static QVector<bool> receivedLines(400, false);  // Marks each line as received
+    emit concealmentChanged(concealedFrames.exchange(0), interpolatedLines.exchange(0), temporalLines.exchange(0));
 
-        if (data.size() < 4) {                           // Check minimum packet size
-            qWarning() << "Incomplete packet received. Packet too small:" << data.size();
-            return;
-        }
+    if (recorder->isOpen()) {
+        emit recorderStatsChanged(recorder->writtenFrames(), recorder->droppedFrames());
+    }
 
-        QMutexLocker lock(&imageMutex);                  // Protecting Image Access
+    const MetricsSnapshot snapshot = collectMetrics();
+    emit metricsUpdated(snapshot);
+    metricsLog.append(snapshot);
+}
 
-        // Check frame header packet (ignore first 4 bytes, all subsequent 0xAA)
-        if (data.mid(4).trimmed() == QByteArray(data.size() - 4, char(0xAA))) {
-            // qDebug() << "Frame start packet received.";
-            frameValid = true;
-            currentLine = 0;
-            frameBuffer.fill(QByteArray());              // Flush the frame buffer
-            receivedLines.fill(false);                   // Reset line receive state
-            return;
-        }
+MetricsSnapshot UdpFrameProcessor::collectMetrics() {
+    MetricsSnapshot snapshot;
+    snapshot.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    snapshot.intervalSeconds = metricsInterval.restart() / 1000.0;
 
-        // Check end-of-frame packet (ignore first 4 bytes, all subsequent are 0xBB)
-        if (data.mid(4).trimmed() == QByteArray(data.size() - 4, char(0xBB))) {
-            // qDebug() << "Frame end packet received.";
-            if (frameValid) {
-                // Interpolation compensation for missing rows
-                for (int i = 0; i < 400; ++i) {
-                    if (!receivedLines[i]) {
-                        // up-down interpolation
-                        QByteArray topLine = (i > 0 && receivedLines[i - 1]) ? frameBuffer[i - 1] : QByteArray();
-                        QByteArray bottomLine = (i < 399 && receivedLines[i + 1]) ? frameBuffer[i + 1] : QByteArray();
-
-                        if (!topLine.isEmpty() && !bottomLine.isEmpty()) {
-                            QByteArray interpolatedLine(topLine.size(), 0);
-                            for (int j = 0; j < topLine.size(); ++j) {
-                                interpolatedLine[j] = (topLine[j] + bottomLine[j]) / 2;
-                            }
-                            frameBuffer[i] = interpolatedLine;
-                        } else if (!topLine.isEmpty()) {
-                            frameBuffer[i] = topLine;     // Fill with the previous line
-                        } else if (!bottomLine.isEmpty()) {
-                            frameBuffer[i] = bottomLine;  // Fill in with the next line
-                        }
-                    }
-                }
-
-                // Copy data to image and refresh
-                for (int i = 0; i < 400; ++i) {
-                    if (!frameBuffer[i].isEmpty()) {
-                        uchar *imageBits = image.bits() + (i * image.bytesPerLine());
-                        const QByteArray &lineData = frameBuffer[i];
-                        for (int j = 0; j < lineData.size() / 2; ++j) {
-                            quint16 rgb565 = static_cast<quint16>((lineData[j * 2] << 8) | (lineData[j * 2 + 1] & 0xFF));
-
-                            // RGB565 -> RGB888 conversion correction
-                            uchar r = (rgb565 >> 11) & 0x1F;
-                            uchar g = (rgb565 >> 5) & 0x3F;
-                            uchar b = rgb565 & 0x1F;
-
-                            r = (r << 3) | (r >> 2);
-                            g = (g << 2) | (g >> 4);
-                            b = (b << 3) | (b >> 2);
-
-                            imageBits[j * 3] = r;
-                            imageBits[j * 3 + 1] = g;
-                            imageBits[j * 3 + 2] = b;
-                        }
-                    }
-                }
-
-                frameCount++;
-                update();  // trigger refresh
-                if (isRecording && videoWriter.isOpened()) {
-                    writeFrameToVideo();  // Save current frame to video
-                }
-
-                // qDebug() << "Frame completed and updated.";
-            }
-            frameValid = false; // End current frame
-            return;
-        }
+    snapshot.packetsReceived = packetRing.pushedCount();
+    snapshot.ringOverflow = packetRing.overflowCount();
+    snapshot.socketOverflow = receiver->socketOverflowCount();
+    if (snapshot.intervalSeconds > 0.0) {
+        snapshot.packetsPerSecond = (snapshot.packetsReceived - intervalPackets) / snapshot.intervalSeconds;
+    }
 
-        // Processing common line packets
-        if (frameValid) {
-            int index = currentLine; // Use the current line number as the index
-            if (index >= 0 && index < 400) {
-                frameBuffer[index] = data.mid(4);      // Stores RGB565 data, ignores first 4 bytes
-                receivedLines[index] = true;           // Marks the line as received
-                // qDebug() << "Line" << currentLine << "updated.";
-                currentLine++;
-            } else {
-                qWarning() << "Invalid line number:" << currentLine;
-            }
-        }
-        }, Qt::QueuedConnection);
+    // Counters are written by the drain thread; each one is read atomically
+    const FrameReassembler::Stats &stats = reassembler.stats();
+    snapshot.runtPackets = stats.runtPackets;
+    snapshot.outOfRangeLines = stats.outOfRangeLines;
+    snapshot.duplicateLines = stats.duplicateLines;
+    snapshot.lateLines = stats.lateLines;
+    snapshot.missingStartMarkers = stats.missingStartMarkers;
+    snapshot.missingEndMarkers = stats.missingEndMarkers;
+    snapshot.framesComplete = stats.framesComplete;
+    snapshot.framesIncomplete = stats.framesIncomplete;
+    snapshot.framesEmpty = stats.framesEmpty;
+    snapshot.framesNoBuffer = stats.framesNoBuffer;
+    snapshot.interpolatedRows = stats.interpolatedLines;
+    snapshot.temporalRows = stats.temporalLines;
+
+    const quint64 concealedRows = snapshot.interpolatedRows + snapshot.temporalRows;
+    const quint64 incompleteFrames = snapshot.framesIncomplete - intervalIncomplete;
+    if (incompleteFrames > 0) {
+        snapshot.concealedRowsPerFrame = double(concealedRows - intervalConcealedRows) / incompleteFrames;
+    }
+
+    snapshot.framesPainted = framesPainted;
+    snapshot.framesSkipped = displayScheduler->skippedFrames();
+    snapshot.rowsPacked = displayScaler.packedRows();
+    snapshot.repaintedArea = displayScheduler->repaintedArea();
+    snapshot.recorderDropped = recorder->droppedFrames();
+    if (detector) {
+        snapshot.detectionRuns = detector->completedRuns();
+        snapshot.detectionSkipped = detector->skippedRuns();
+    }
+
+    const LatencyHistogram::Counts toPublish = arrivalToPublish.counts();
+    const LatencyHistogram::Counts toPaint = publishToPaint.counts();
+    const LatencyHistogram::Counts endToEnd = arrivalToPaint.counts();
+    snapshot.arrivalToPublish = LatencyHistogram::summarize(toPublish, intervalArrivalToPublish);
+    snapshot.publishToPaint = LatencyHistogram::summarize(toPaint, intervalPublishToPaint);
+    snapshot.arrivalToPaint = LatencyHistogram::summarize(endToEnd, intervalArrivalToPaint);
+
+    intervalPackets = snapshot.packetsReceived;
+    intervalIncomplete = snapshot.framesIncomplete;
+    intervalConcealedRows = concealedRows;
+    intervalArrivalToPublish = toPublish;
+    intervalPublishToPaint = toPaint;
+    intervalArrivalToPaint = endToEnd;
+    return snapshot;
 }
 
+void UdpFrameProcessor::publishFrame(FrameReassembler::Frame &frame, bool complete) {
+    FrameBuffer *buffer = frame.buffer;  // Missing rows are already concealed
+
+    if (!complete) {
+        concealedFrames++;
+        interpolatedLines += buffer->interpolatedLines;
+        temporalLines += buffer->temporalLines;
+    }
+
+    // Nothing else can see the buffer yet, so it is adjusted in place
+    imageAdjuster.apply(*buffer);
+
+    buffer->publishNs = PipelineMetrics::wallClockNs();
+    if (buffer->arrivalNs > 0) {
+        arrivalToPublish.record(buffer->publishNs - buffer->arrivalNs);
+    }
+
+    // Atomic swap: readers move to this frame on their next latest() call
+    framePool.publish(buffer);
+    frame.buffer = nullptr;
+
+    frameCount++;  // The display scheduler notices the new sequence on its next refresh tick
+
+    if (detector) {
+        detector->frameReady();  // Inference takes the newest frame when it is free
+    }
+
+    // Only this thread ever writes pool buffers, so the frame stays intact
+    // here even though it is already published
+    if (recorder->isOpen()) {
+        recorder->enqueue(*buffer);  // Converted and queued, encoded on the recorder thread
+    }
+}
 
 QImage UdpFrameProcessor::getCurrentFrame() {
-    QMutexLocker lock(&imageMutex);
-    return image.copy();  // Return a copy of the image to ensure thread safety
+    // Shares the pool buffer; the image holds a reference until it is destroyed
+    return framePool.latest().image();
+}
+
+FrameHandle UdpFrameProcessor::currentFrame() const {
+    return framePool.latest();
+}
+
+QString UdpFrameProcessor::fileNamePrefix() const {
+    return streamName.isEmpty() ? QString() : streamName + "_";
 }
 
 void UdpFrameProcessor::saveSnapshot(const QString &directory) {
     if (!directory.isEmpty()) {
-        QString fileName = directory + "/snapshot_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".png";
+        QString fileName = directory + "/snapshot_" + fileNamePrefix() + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".png";
         if (getCurrentFrame().save(fileName)) {
             qDebug() << "Snapshot saved to" << fileName;
         } else {
@@ -212,70 +393,101 @@ void UdpFrameProcessor::saveSnapshot(const QString &directory) {
     }
 }
 
-void UdpFrameProcessor::toggleRecording(const QString &directory, const QString &format, int fps) {
-    if (!isRecording) {
-        // Make sure the catalog exists
-        QDir dir(directory);
-        if (!dir.exists()) {
-            qWarning() << "Directory does not exist. Attempting to create:" << directory;
-            if (!dir.mkpath(".")) {
-                qWarning() << "Failed to create directory:" << directory;
-                emit recordingStateChanged(false);
-                return;
-            }
-        }
+bool UdpFrameProcessor::startRecording(const QString &directory, const QString &format, int fps) {
+    if (recorder->isOpen()) {
+        return true;
+    }
 
-        QString fileName = directory + "/recording_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + "." + format;
-        int codec = (format == "avi") ? cv::VideoWriter::fourcc('M', 'J', 'P', 'G') : cv::VideoWriter::fourcc('H', '2', '6', '4');
-        int frameWidth = image.width();
-        int frameHeight = image.height();
-
-        qDebug() << "Attempting to open file:" << fileName;
-        qDebug() << "Codec:" << codec;
-        qDebug() << "Resolution:" << frameWidth << "x" << frameHeight;
-        qDebug() << "FPS:" << fps;
-
-        try {
-            // Try to open the video writer
-            videoWriter.open(fileName.toStdString(), codec, fps, cv::Size(frameWidth, frameHeight));
-        } catch (const cv::Exception &e) {
-            qWarning() << "OpenCV exception while opening VideoWriter:" << e.what();
+    // Make sure the catalog exists
+    QDir dir(directory);
+    if (!dir.exists()) {
+        qWarning() << "Directory does not exist. Attempting to create:" << directory;
+        if (!dir.mkpath(".")) {
+            qWarning() << "Failed to create directory:" << directory;
             emit recordingStateChanged(false);
-            return;
+            return false;
         }
+    }
 
-        if (!videoWriter.isOpened()) {
-            qWarning() << "Failed to open VideoWriter. Check codec, resolution, or file permissions.";
-            emit recordingStateChanged(false);
-            return;
-        }
+    QString fileName = directory + "/recording_" + fileNamePrefix() + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + "." + format;
+    int codec = (format == "avi") ? cv::VideoWriter::fourcc('M', 'J', 'P', 'G') : cv::VideoWriter::fourcc('H', '2', '6', '4');
+    int frameWidth = framePool.width();
+    int frameHeight = framePool.height();
 
-        // Start recording
-        isRecording = true;
-        emit recordingStateChanged(true);  // Notification UI updates recording status
-        qDebug() << "Recording started.";
-    } else {
-        // Stop Recording Logic
-        if (videoWriter.isOpened()) {
-            videoWriter.release();
-            qDebug() << "VideoWriter released, recording stopped.";
-        } else {
-            qWarning() << "VideoWriter was not open but recording stop requested.";
-        }
+    qDebug() << "Attempting to open file:" << fileName;
+    qDebug() << "Codec:" << codec;
+    qDebug() << "Resolution:" << frameWidth << "x" << frameHeight;
+    qDebug() << "FPS:" << fps;
 
-        // Stop Recording Status
-        isRecording = false;
-        emit recordingStateChanged(false);  // Notification UI updates recording status
-        qDebug() << "Recording stopped.";
+    bool opened = recorder->open(fileName, codec, fps, frameWidth, frameHeight);
+
+    if (!opened) {
+        qWarning() << "Failed to open VideoWriter. Check codec, resolution, or file permissions.";
+        emit recordingStateChanged(false);
+        return false;
+    }
+
+    emit recordingStateChanged(true);  // Notification UI updates recording status
+    qDebug() << "Recording started.";
+    return true;
+}
+
+void UdpFrameProcessor::stopRecording() {
+    if (!recorder->isOpen()) {
+        return;
+    }
+
+    // Stop Recording Logic: flushes the queue and closes the file
+    recorder->close();
+    emit recorderStatsChanged(recorder->writtenFrames(), recorder->droppedFrames());
+    emit recordingStateChanged(false);  // Notification UI updates recording status
+    qDebug() << "Recording stopped.";
+}
+
+void UdpFrameProcessor::toggleRecording(const QString &directory, const QString &format, int fps) {
+    if (!recorder->isOpen()) {
+        startRecording(directory, format, fps);
+    } else {
+        stopRecording();
     }
 }
 
 void UdpFrameProcessor::setFlipHorizontal(bool enabled) {
     flipHorizontal = enabled;
-    // update();  // Request a repaint to reflect the change
+    update();  // Request a repaint to reflect the change
 }
 
 void UdpFrameProcessor::setFlipVertical(bool enabled) {
     flipVertical = enabled;
-    // update();  // Request a repaint to reflect the change
+    update();  // Request a repaint to reflect the change
+}
+
+void UdpFrameProcessor::setBrightness(int value) {
+    brightness = value;
+    imageAdjuster.setBrightness(value);
+    reassembler.invalidateRows();
+    if (toneTable) {
+        toneTable->rebuild(brightness, gamma);
+    }
+}
+
+void UdpFrameProcessor::setGamma(int value) {
+    gamma = value;
+    imageAdjuster.setGamma(value);
+    reassembler.invalidateRows();
+    if (toneTable) {
+        toneTable->rebuild(brightness, gamma);
+    }
+}
+
+void UdpFrameProcessor::setSharpness(int value) {
+    imageAdjuster.setSharpness(value);
+    reassembler.setChangeSpread(imageAdjuster.rowReach());
+    reassembler.invalidateRows();
+}
+
+void UdpFrameProcessor::setDenoise(int value) {
+    imageAdjuster.setDenoise(value);
+    reassembler.setChangeSpread(imageAdjuster.rowReach());
+    reassembler.invalidateRows();
 }
@@ -13,23 +13,50 @@
 #include <QDir>
 #include <QDebug>
 #include <QMutexLocker>
-#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <memory>
 #include "UdpReceiver.h"
+#include "PacketRing.h"
+#include "PacketDrainThread.h"
+#include "FrameReassembler.h"
+#include "DisplayScaler.h"
+#include "DisplayScheduler.h"
+#include "FramePool.h"
+#include "ImageAdjuster.h"
+#include "MetricsLog.h"
+#include "ObjectTracker.h"
+#include "PacketCapture.h"
+#include "PipelineMetrics.h"
+#include "Rgb565ToneTable.h"
+#include "StreamConfig.h"
+#include "VideoRecorder.h"
+#include "YoloProcessor.h"
 
 class UdpFrameProcessor : public QWidget {
     Q_OBJECT
 
 public:
-    explicit UdpFrameProcessor(QWidget *parent = nullptr);
+    // settings gives the camera's geometry, packet layout, listen address,
+    // recording queue, raw capture, object detection and metrics file options
+    explicit UdpFrameProcessor(const StreamSettings &settings = StreamSettings(), QWidget *parent = nullptr);
     ~UdpFrameProcessor();
 
-    // Get the current frame image (thread-safe)
+    // Get the current frame image (thread-safe, shares the frame buffer)
     QImage getCurrentFrame();
 
+    // Reference-counted handle to the newest published frame
+    FrameHandle currentFrame() const;
+
 public slots:
     // Save a snapshot
     void saveSnapshot(const QString &directory);
 
+    // Start video recording, returns false if the file could not be opened
+    bool startRecording(const QString &directory, const QString &format, int fps = 30);
+
+    // Stop video recording, flushing the queued frames
+    void stopRecording();
+
     // Start/Stop video recording
     void toggleRecording(const QString &directory, const QString &format, int fps = 30);
 
@@ -39,6 +66,13 @@ public slots:
     // Set vertical image flip
     void setFlipVertical(bool enabled);
 
+    // Image adjustments from the control panel sliders, applied to every
+    // frame before it is published
+    void setBrightness(int value);
+    void setGamma(int value);
+    void setSharpness(int value);
+    void setDenoise(int value);
+
 signals:
     // Signal emitted when recording state changes
     void recordingStateChanged(bool isRecording);
@@ -47,46 +81,143 @@ protected:
     // Handles the paint event to display the frame
     void paintEvent(QPaintEvent *event) override;
 
+    // Starts repaint pacing once the widget has a window and a screen
+    void showEvent(QShowEvent *event) override;
+
 signals:
     // Updates FPS once per second
     void fpsChanged(int fps);
 
+    // Receive batching statistics, forwarded from the receiver once per second
+    void receiveStatsChanged(double packetsPerSyscall, double batchOccupancy);
+
+    // Datagrams lost because the packet ring was full (not network loss)
+    void ringOverflowChanged(quint64 droppedPackets);
+
+    // Datagrams the kernel dropped because the socket buffer was full
+    void socketOverflowChanged(quint64 droppedPackets);
+
+    // Frames published with missing rows and how those rows were concealed,
+    // over the last second
+    void concealmentChanged(int frames, int interpolatedLines, int temporalLines);
+
+    // Frames written and frames dropped by the recorder queue (not network loss)
+    void recorderStatsChanged(quint64 writtenFrames, quint64 droppedFrames);
+
+    // Loss counters and latency percentiles, once per second
+    void metricsUpdated(const MetricsSnapshot &snapshot);
+
 private slots:
     // Update FPS counter
     void updateFPS();
 
-    // Process received frame data
-    void processFrameData(const QByteArray &data);
+    // Correct the tracked boxes with a new inference result (GUI thread)
+    void onDetectionFinished(const DetectionResult &result);
 
 private:
-    // Helper function: Write the current frame to the video file
-    void writeFrameToVideo();
+    // Publish a retired frame and record it (drain thread)
+    void publishFrame(FrameReassembler::Frame &frame, bool complete);
+
+    // Assemble the metrics for the interval that just ended (GUI thread)
+    MetricsSnapshot collectMetrics();
 
-    // Image data and thread synchronization
-    QImage image;
-    QMutex imageMutex;
+    // Render the newest frame for the display scheduler; returns the part of
+    // the widget to repaint (GUI thread)
+    QRegion renderNewestFrame();
+
+    // Outline the tracked objects, predicted for frame, over the frame drawn at target
+    void drawDetections(QPainter &painter, const QRect &target, const FrameBuffer &frame);
+
+    // Widget area drawDetections covers, outlines and labels included
+    QRegion detectionRegion(const QRect &target, const FrameBuffer &frame);
+
+    // Widget rectangle outlining box (frame pixels) of frame drawn at target
+    QRectF detectionOutline(const QRect &box, const QRect &target, const FrameBuffer &frame) const;
+
+    // "camera2_" for snapshot and recording file names, empty for a single stream
+    QString fileNamePrefix() const;
 
     // FPS and recording timers
     QTimer *fpsTimer;
     QElapsedTimer recordingTimer;
 
     // Frame counter and received line count
-    int frameCount;
+    std::atomic<int> frameCount;
+    std::atomic<int> concealedFrames;
+    std::atomic<int> interpolatedLines;
+    std::atomic<int> temporalLines;
     int receivedLines;
 
+    // Stream name from the config, empty when it is the only stream
+    QString streamName;
+
     // UDP receiver and processing thread
     UdpReceiver *receiver;
     QThread *receiverThread;
 
+    // Packet ring between the receiver thread and reassembly
+    PacketRing packetRing;
+    PacketDrainThread *drainThread;
+
+    // Frame buffers shared by reassembly, display and snapshots
+    FramePool framePool;
+
+    // Frame reassembly, only touched by the drain thread
+    FrameReassembler reassembler;
+
+    // Raw packet capture, opened before the drain thread starts and then only
+    // touched by it
+    PacketCapture packetCapture;
+
+    // Brightness, gamma, sharpness and denoise, applied on the drain thread
+    ImageAdjuster imageAdjuster;
+
+    // Fused decode and tone table when [processing] decoder=lut, else null.
+    // The sliders' last values are kept to rebuild it (GUI thread).
+    std::unique_ptr<Rgb565ToneTable> toneTable;
+    int brightness;
+    int gamma;
+
     // Image flipping states
     bool flipHorizontal;
     bool flipVertical;
 
-    // OpenCV video writer for recording
-    cv::VideoWriter videoWriter;
-
-    // Recording state flag
-    bool isRecording;
+    // Scaled, flipped RGB32 copy of the newest frame for painting (GUI thread)
+    DisplayScaler displayScaler;
+    FrameHandle displayedFrame;  // Frame displayScaler last rendered for the scheduler
+    QRegion detectionOverlay;    // Widget area the detection boxes were last drawn over
+
+    // Paces repaints to the display refresh rate
+    DisplayScheduler *displayScheduler;
+
+    // Video recorder with its own encoder thread
+    VideoRecorder *recorder;
+
+    // YOLO on published frames when [detection] is enabled, else null
+    YoloProcessor *detector;
+    ObjectTracker tracker;  // Moves the boxes between results, GUI thread only
+
+    // Latency from the last packet of a frame to publish and to first paint;
+    // arrival to publish is recorded on the drain thread, the rest on the GUI thread
+    LatencyHistogram arrivalToPublish;
+    LatencyHistogram publishToPaint;
+    LatencyHistogram arrivalToPaint;
+
+    // Everything below is only touched by the GUI thread
+    quint64 lastPaintedSequence;
+    quint64 framesPainted;
+
+    // Totals at the start of the current metrics interval
+    QElapsedTimer metricsInterval;
+    quint64 intervalPackets;
+    quint64 intervalIncomplete;
+    quint64 intervalConcealedRows;
+    LatencyHistogram::Counts intervalArrivalToPublish;
+    LatencyHistogram::Counts intervalPublishToPaint;
+    LatencyHistogram::Counts intervalArrivalToPaint;
+
+    // Rolling JSON lines file, empty unless enabled in the config
+    MetricsLog metricsLog;
 };
 
 #endif // UDP_FRAME_PROCESSOR_H
@@ -7,41 +7,132 @@ Version: 4.4
 Language: C++ (Qt Framework)
 Description:
 This file implements the UdpReceiver class,
-which is responsible for receiving UDP packets,
-managing the network interface using Tshark, and
-emitting processed frame data to be used by
-the frame processor. It includes functionalities
-such as buffer clearing, real-time data capturing,
-and packet processing.
+which is responsible for receiving UDP packets and
+writing received datagrams, stamped with their
+sender and kernel receive time, into the packet ring
+consumed by the frame processor. It includes functionalities
+such as socket buffer tuning, kernel drop counting,
+real-time data capturing, and packet processing.
 ===================================================
 */
 
 #include "UdpReceiver.h"
+#include "PipelineMetrics.h"
 #include <QDebug>
 
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#endif
+
+#ifdef Q_OS_LINUX
+namespace {
+// Control buffer per batch entry: one receive timestamp and one drop count
+const size_t kControlSize = CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(quint32));
+const size_t kControlWords = (kControlSize + sizeof(quint64) - 1) / sizeof(quint64);
+}
+#endif
+
 UdpReceiver::UdpReceiver(QObject *parent)
     : QObject(parent),
       mrecv(new QUdpSocket(this)),
-      tsharkProcess(new QProcess(this)),
-      bufferCleaner(new QTimer(this)) {
-    // Periodically clear the buffer every 10 seconds
-    connect(bufferCleaner, &QTimer::timeout, this, &UdpReceiver::clearBuffer);
-    bufferCleaner->start(10000); // Clear buffer every 10 seconds
+      statsTimer(new QTimer(this)),
+      ring(nullptr),
+      sourceFilter(0),
+      sharePort(false),
+      receiveBufferBytes(0),
+      forceReceiveBuffer(false),
+      busyPollMicroseconds(0),
+#ifdef Q_OS_LINUX
+      receiveMode(BatchedReceive),
+#else
+      receiveMode(SocketReceive),
+#endif
+      batchSize(64),
+      batchFd(-1),
+      batchNotifier(nullptr),
+      statSyscalls(0),
+      statPackets(0),
+      reportedOverflow(0),
+      lastKernelDrops(0),
+      socketOverflow(0),
+      reportedSocketOverflow(0) {
+    connect(statsTimer, &QTimer::timeout, this, &UdpReceiver::reportBatchStats);
 }
 
 UdpReceiver::~UdpReceiver() {
-    // Gracefully terminate the Tshark process
-    if (tsharkProcess && tsharkProcess->state() == QProcess::Running) {
-        tsharkProcess->terminate();
-        if (!tsharkProcess->waitForFinished(3000)) {
-            qWarning() << "Tshark did not exit gracefully, killing process.";
-            tsharkProcess->kill();
-            tsharkProcess->waitForFinished();
-        }
+#ifdef Q_OS_LINUX
+    if (batchFd >= 0) {
+        ::close(batchFd);
     }
+#endif
+}
+
+void UdpReceiver::setReceiveMode(ReceiveMode mode) {
+#ifndef Q_OS_LINUX
+    if (mode == BatchedReceive) {
+        qWarning() << "Batched receive requires recvmmsg(), falling back to socket mode.";
+        mode = SocketReceive;
+    }
+#endif
+    receiveMode = mode;
+}
+
+void UdpReceiver::setBatchSize(int size) {
+    batchSize = qBound(1, size, 1024);
+}
+
+void UdpReceiver::setPacketRing(PacketRing *packetRing) {
+    ring = packetRing;
+}
+
+void UdpReceiver::setSourceAddress(const QString &address) {
+    sourceFilter = address.isEmpty() ? 0 : QHostAddress(address).toIPv4Address();
+    if (!address.isEmpty() && sourceFilter == 0) {
+        qWarning() << "Ignoring source filter, not an IPv4 address:" << address;
+    }
+}
+
+void UdpReceiver::setPortSharing(bool enabled) {
+    sharePort = enabled;
+}
+
+void UdpReceiver::setReceiveBufferSize(int bytes, bool force) {
+    receiveBufferBytes = qMax(0, bytes);
+    forceReceiveBuffer = force;
+}
+
+void UdpReceiver::setBusyPoll(int microseconds) {
+    busyPollMicroseconds = qMax(0, microseconds);
 }
 
 void UdpReceiver::startReceiving(const QString &address, quint16 port) {
+    if (!ring) {
+        qWarning() << "No packet ring attached, not receiving.";
+        return;
+    }
+
+    discardSlots.resize(batchSize);
+    batchSlots.resize(batchSize);
+    statsTimer->start(1000);  // Report batch statistics every second
+
+    if (receiveMode == BatchedReceive) {
+        if (openBatchedSocket(address, port)) {
+            return;
+        }
+        qWarning() << "Batched receive unavailable, falling back to socket mode.";
+        receiveMode = SocketReceive;
+    }
+
+    if (sharePort) {
+        qWarning() << "Port sharing needs batched receive; datagrams for port" << port
+                   << "may reach another stream's socket.";
+    }
+
     QHostAddress maddr(address);
 
     // Bind to the specified address and port
@@ -50,73 +141,300 @@ void UdpReceiver::startReceiving(const QString &address, quint16 port) {
         return;
     }
 
+    if (receiveBufferBytes > 0) {
+        mrecv->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, receiveBufferBytes);
+    }
+
     qDebug() << "Listening for UDP packets on" << address << "port" << port;
 
     // Connect the signal to process incoming data
     connect(mrecv, &QUdpSocket::readyRead, this, &UdpReceiver::readPendingDatagrams);
 }
 
-void UdpReceiver::startTshark(const QString &interfaceName) {
-    QString program = "D:/Program Files (x86)/Wireshark/tshark.exe";
-    QString deviceName = interfaceName.isEmpty() ? "Ethernet 2" : interfaceName;
-
-    // Set up circular buffer parameters
-    QStringList arguments = {
-        "-i", deviceName,          // Specify network interface to listen on
-        "-l",                      // Enable real-time output
-        "-n",                      // Disable hostname resolution
-        "-b", "filesize:3145728",  // Maximum file size of 3GB (unit: KB)
-        "-b", "files:3",           // Keep up to 3 files
-        "-w", "E:/sharkfile/capture.pcap"  // Set capture file save path
-    };
-
-    qDebug() << "Starting tshark with program:" << program << "arguments:" << arguments;
-    tsharkProcess->start(program, arguments);
-
-    // Capture error output
-    connect(tsharkProcess, &QProcess::readyReadStandardError, this, [=]() {
-        QByteArray errorOutput = tsharkProcess->readAllStandardError();
-        if (!errorOutput.isEmpty()) {
-            qWarning() << "Tshark Error Output:" << errorOutput;
+bool UdpReceiver::openBatchedSocket(const QString &address, quint16 port) {
+#ifdef Q_OS_LINUX
+    QHostAddress maddr(address);
+    if (maddr.protocol() != QAbstractSocket::IPv4Protocol) {
+        qWarning() << "Batched receive only supports IPv4 addresses:" << address;
+        return false;
+    }
+
+    batchFd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (batchFd < 0) {
+        qWarning() << "Failed to create UDP socket:" << strerror(errno);
+        return false;
+    }
+
+    int enable = 1;
+    ::setsockopt(batchFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+#ifdef SO_REUSEPORT
+    // Every socket of the group must set this before binding
+    if (sharePort && ::setsockopt(batchFd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+        qWarning() << "Failed to enable SO_REUSEPORT:" << strerror(errno);
+    }
+#endif
+    configureBatchedSocket();
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(maddr.toIPv4Address());
+    if (::bind(batchFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        qWarning() << "Failed to bind to address:" << address << "port:" << port << strerror(errno);
+        ::close(batchFd);
+        batchFd = -1;
+        return false;
+    }
+
+    // A connected UDP socket only receives from its peer, and within an
+    // SO_REUSEPORT group the kernel prefers the socket connected to the sender,
+    // so each camera lands on its own stream's socket. Port 0 accepts any
+    // sender port.
+    if (sourceFilter != 0) {
+        sockaddr_in peer;
+        memset(&peer, 0, sizeof(peer));
+        peer.sin_family = AF_INET;
+        peer.sin_port = 0;
+        peer.sin_addr.s_addr = htonl(sourceFilter);
+        if (::connect(batchFd, reinterpret_cast<sockaddr *>(&peer), sizeof(peer)) < 0) {
+            qWarning() << "Failed to restrict the socket to sender" << QHostAddress(sourceFilter).toString() << strerror(errno);
+        } else {
+            // Datagrams queued between bind() and connect() may come from
+            // another stream's camera; connect() does not remove them
+            int stale = 0;
+            while (::recv(batchFd, discardSlots[0].data, PacketSlot::Capacity, MSG_DONTWAIT) >= 0) {
+                stale++;
+            }
+            if (stale > 0) {
+                qDebug() << "Discarded" << stale << "datagrams received before the sender filter applied";
+            }
         }
-    });
+    }
 
-    // Check if Tshark started successfully
-    if (!tsharkProcess->waitForStarted()) {
-        qWarning() << "Failed to start tshark. Error:" << tsharkProcess->errorString();
-    } else {
-        qDebug() << "Tshark started successfully.";
+    // One message header per batch entry; the iovecs are pointed at ring slots per call
+    batchHeaders.resize(batchSize);
+    batchIovecs.resize(batchSize);
+    batchAddresses.resize(batchSize);
+    batchControl.resize(batchSize * kControlWords);
+    for (int i = 0; i < batchSize; ++i) {
+        batchIovecs[i].iov_len = PacketSlot::Capacity;
+        memset(&batchHeaders[i], 0, sizeof(mmsghdr));
+        batchHeaders[i].msg_hdr.msg_iov = &batchIovecs[i];
+        batchHeaders[i].msg_hdr.msg_iovlen = 1;
+        batchHeaders[i].msg_hdr.msg_name = &batchAddresses[i];
+        batchHeaders[i].msg_hdr.msg_control = &batchControl[i * kControlWords];
     }
+
+    batchNotifier = new QSocketNotifier(batchFd, QSocketNotifier::Read, this);
+    connect(batchNotifier, &QSocketNotifier::activated, this, &UdpReceiver::readDatagramBatches);
+
+    qDebug() << "Listening for UDP packets on" << address << "port" << port
+             << "with recvmmsg batches of" << batchSize << (sharePort ? "(shared port)" : "");
+    return true;
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(port);
+    return false;
+#endif
 }
 
-void UdpReceiver::readPendingDatagrams() {
-    // Read incoming packets in bulk
-    while (mrecv->hasPendingDatagrams()) {
-        QByteArray datagram;
-        datagram.resize(mrecv->pendingDatagramSize());
-        mrecv->readDatagram(datagram.data(), datagram.size());
+void UdpReceiver::configureBatchedSocket() {
+#ifdef Q_OS_LINUX
+    int enable = 1;
+
+    if (receiveBufferBytes > 0) {
+        bool applied = false;
+#ifdef SO_RCVBUFFORCE
+        if (forceReceiveBuffer) {
+            applied = ::setsockopt(batchFd, SOL_SOCKET, SO_RCVBUFFORCE, &receiveBufferBytes, sizeof(receiveBufferBytes)) == 0;
+            if (!applied) {
+                qWarning() << "SO_RCVBUFFORCE failed (needs CAP_NET_ADMIN):" << strerror(errno);
+            }
+        }
+#endif
+        if (!applied && ::setsockopt(batchFd, SOL_SOCKET, SO_RCVBUF, &receiveBufferBytes, sizeof(receiveBufferBytes)) < 0) {
+            qWarning() << "Failed to set SO_RCVBUF:" << strerror(errno);
+        }
 
-        // Emit signal when a new frame is received
-        if (!datagram.isEmpty()) {
-            emit newFrameData(datagram);
+        // The kernel reports twice the usable size, and caps plain SO_RCVBUF at net.core.rmem_max
+        int granted = 0;
+        socklen_t length = sizeof(granted);
+        if (::getsockopt(batchFd, SOL_SOCKET, SO_RCVBUF, &granted, &length) == 0) {
+            if (granted / 2 < receiveBufferBytes) {
+                qWarning() << "Receive buffer limited to" << granted / 2 << "of" << receiveBufferBytes
+                           << "bytes; raise net.core.rmem_max or set forceReceiveBuffer.";
+            } else {
+                qDebug() << "Receive buffer" << granted / 2 << "bytes";
+            }
         }
     }
+
+#ifdef SO_BUSY_POLL
+    if (busyPollMicroseconds > 0
+        && ::setsockopt(batchFd, SOL_SOCKET, SO_BUSY_POLL, &busyPollMicroseconds, sizeof(busyPollMicroseconds)) < 0) {
+        qWarning() << "Failed to enable SO_BUSY_POLL:" << strerror(errno);
+    }
+#endif
+
+    // Every datagram carries the socket's drop count and its kernel receive
+    // time as control messages
+#ifdef SO_RXQ_OVFL
+    if (::setsockopt(batchFd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) < 0) {
+        qWarning() << "Kernel drop counters unavailable:" << strerror(errno);
+    }
+#endif
+#ifdef SO_TIMESTAMPNS
+    if (::setsockopt(batchFd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0) {
+        qWarning() << "Kernel receive timestamps unavailable:" << strerror(errno);
+    }
+#endif
+#endif
 }
 
-#include <QtConcurrent>
+void UdpReceiver::readDatagramBatches() {
+#ifdef Q_OS_LINUX
+    // Drain the socket until the kernel queue is empty
+    for (;;) {
+        // Receive straight into free ring slots; when the ring is full, drain
+        // into the scratch slab instead so the loss is counted as ring overflow
+        int wanted = ring->acquire(batchSlots.data(), batchSize);
+        bool discarding = wanted == 0;
+        if (discarding) {
+            wanted = batchSize;
+        }
+        for (int i = 0; i < wanted; ++i) {
+            batchIovecs[i].iov_base = discarding ? discardSlots[i].data : batchSlots[i]->data;
+            batchHeaders[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);  // Overwritten by the kernel
+            batchHeaders[i].msg_hdr.msg_controllen = kControlSize;     // Likewise
+        }
+
+        int received = ::recvmmsg(batchFd, batchHeaders.data(), wanted, MSG_DONTWAIT, nullptr);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                qWarning() << "recvmmsg failed:" << strerror(errno);
+            }
+            break;
+        }
+
+        statSyscalls++;
+        statPackets += received;
 
-void UdpReceiver::clearBuffer() {
-    QtConcurrent::run([this]() {
-        int packetsCleared = 0;
+        qint64 now = 0;  // Clock read at most once per batch, for datagrams without a timestamp
+        for (int i = 0; i < received; ++i) {
+            msghdr &header = batchHeaders[i].msg_hdr;
+            qint64 timestampNs = 0;
+            for (cmsghdr *control = CMSG_FIRSTHDR(&header); control; control = CMSG_NXTHDR(&header, control)) {
+                if (control->cmsg_level != SOL_SOCKET) {
+                    continue;
+                }
+#ifdef SO_TIMESTAMPNS
+                if (control->cmsg_type == SCM_TIMESTAMPNS) {
+                    timespec stamp;
+                    memcpy(&stamp, CMSG_DATA(control), sizeof(stamp));
+                    timestampNs = static_cast<qint64>(stamp.tv_sec) * 1000000000 + stamp.tv_nsec;
+                }
+#endif
+#ifdef SO_RXQ_OVFL
+                if (control->cmsg_type == SO_RXQ_OVFL) {
+                    // Drops on this socket so far, as of this datagram; wraps at 32 bits
+                    quint32 drops;
+                    memcpy(&drops, CMSG_DATA(control), sizeof(drops));
+                    socketOverflow.fetch_add(quint32(drops - lastKernelDrops), std::memory_order_relaxed);
+                    lastKernelDrops = drops;
+                }
+#endif
+            }
 
-        while (mrecv->hasPendingDatagrams()) {
-            mrecv->readDatagram(nullptr, 0); // Discard the packet
-            packetsCleared++;
+            if (discarding) {
+                continue;
+            }
+            if (timestampNs == 0) {
+                if (now == 0) {
+                    now = PipelineMetrics::wallClockNs();
+                }
+                timestampNs = now;
+            }
+
+            PacketSlot *slot = batchSlots[i];
+            slot->size = static_cast<qint32>(qMin<unsigned int>(batchHeaders[i].msg_len, PacketSlot::Capacity));
+            slot->sourceAddress = ntohl(batchAddresses[i].sin_addr.s_addr);
+            slot->sourcePort = ntohs(batchAddresses[i].sin_port);
+            slot->timestampNs = timestampNs;
+        }
+
+        if (discarding) {
+            ring->recordOverflow(received);
+        } else {
+            ring->commit(received);
+            ring->notifyConsumer();
         }
 
-        qDebug() << "Cleared" << packetsCleared << "datagrams from buffer.";
-    });
+        if (received < wanted) {
+            break;  // Queue drained
+        }
+    }
+#endif
 }
 
+void UdpReceiver::reportBatchStats() {
+    if (statSyscalls == 0) {
+        return;
+    }
+
+    double packetsPerSyscall = double(statPackets) / double(statSyscalls);
+    double occupancy = receiveMode == BatchedReceive ? packetsPerSyscall / batchSize : 1.0;
+    emit batchStatsChanged(packetsPerSyscall, occupancy);
+
+    statSyscalls = 0;
+    statPackets = 0;
+
+    quint64 overflow = ring->overflowCount();
+    if (overflow != reportedOverflow) {
+        reportedOverflow = overflow;
+        emit ringOverflowChanged(overflow);
+    }
+
+    quint64 kernelDrops = socketOverflowCount();
+    if (kernelDrops != reportedSocketOverflow) {
+        reportedSocketOverflow = kernelDrops;
+        emit socketOverflowChanged(kernelDrops);
+    }
+}
+
+void UdpReceiver::readPendingDatagrams() {
+    // Read incoming packets in bulk, directly into ring slots
+    bool committed = false;
+    while (mrecv->hasPendingDatagrams()) {
+        PacketSlot *slot = nullptr;
+        if (ring->acquire(&slot, 1) == 0) {
+            mrecv->readDatagram(discardSlots[0].data, PacketSlot::Capacity);
+            ring->recordOverflow(1);
+            continue;
+        }
+
+        QHostAddress sender;
+        quint16 senderPort = 0;
+        qint64 size = mrecv->readDatagram(slot->data, PacketSlot::Capacity, &sender, &senderPort);
+        statSyscalls++;
+        statPackets++;
+
+        // QUdpSocket cannot be connected to a sender while bound, so filter here
+        if (sourceFilter != 0 && sender.toIPv4Address() != sourceFilter) {
+            continue;
+        }
 
+        if (size > 0) {
+            slot->size = static_cast<qint32>(size);
+            slot->sourceAddress = sender.toIPv4Address();
+            slot->sourcePort = senderPort;
+            slot->timestampNs = PipelineMetrics::wallClockNs();
+            ring->commit(1);
+            committed = true;
+        }
+    }
 
+    if (committed) {
+        ring->notifyConsumer();
+    }
+}
@@ -3,38 +3,122 @@
 
 #include <QObject>
 #include <QUdpSocket>
-#include <QProcess>
 #include <QTimer>
+#include <QSocketNotifier>
+#include <atomic>
+#include <vector>
+#include "PacketRing.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#endif
 
 class UdpReceiver : public QObject {
     Q_OBJECT
 public:
+    // How datagrams are pulled from the kernel
+    enum ReceiveMode {
+        SocketReceive,   // One readDatagram() call per packet through QUdpSocket
+        BatchedReceive   // Up to batchSize packets per recvmmsg() call (Linux only)
+    };
+
     explicit UdpReceiver(QObject *parent = nullptr);
 
+    // Select the receive mode and batch size (call before startReceiving)
+    void setReceiveMode(ReceiveMode mode);
+    void setBatchSize(int size);
+
+    // Ring that received datagrams are written into (call before startReceiving)
+    void setPacketRing(PacketRing *ring);
+
+    // Only accept datagrams from this IPv4 sender; empty accepts any (call before startReceiving)
+    void setSourceAddress(const QString &address);
+
+    // Join an SO_REUSEPORT group with the other streams bound to the same
+    // address and port (batched mode only, call before startReceiving)
+    void setPortSharing(bool enabled);
+
+    // Kernel receive buffer in bytes, 0 keeps the system default. force uses
+    // SO_RCVBUFFORCE to exceed net.core.rmem_max (needs CAP_NET_ADMIN).
+    // Call before startReceiving.
+    void setReceiveBufferSize(int bytes, bool force);
+
+    // Busy-poll the device queue for up to this long when the socket is
+    // empty (SO_BUSY_POLL, batched mode only), 0 disables it
+    void setBusyPoll(int microseconds);
+
+    // Datagrams the kernel dropped because the socket buffer was full
+    // (SO_RXQ_OVFL, batched mode only). Drops are learned from the next
+    // datagram that arrives. Safe to read from any thread.
+    quint64 socketOverflowCount() const { return socketOverflow.load(std::memory_order_relaxed); }
+
     // Start receiving UDP data
     void startReceiving(const QString &address, quint16 port);
 
-    // Start Tshark to keep the network interface active
-    void startTshark(const QString &interfaceName = QString());
-
     virtual ~UdpReceiver();
 
 signals:
-    // Signal emitted when new frame data is received
-    void newFrameData(const QByteArray &data);
+    // Average packets per receive syscall and batch fill ratio (0..1), once per second
+    void batchStatsChanged(double packetsPerSyscall, double batchOccupancy);
 
-private slots:
-    // Clear the buffer periodically
-    void clearBuffer();
+    // Total datagrams discarded because the packet ring was full
+    void ringOverflowChanged(quint64 droppedPackets);
 
+    // Total datagrams the kernel dropped because the socket buffer was full
+    void socketOverflowChanged(quint64 droppedPackets);
+
+private slots:
     // Process incoming UDP packets
     void readPendingDatagrams();
 
+    // Drain the socket with recvmmsg() in batched mode
+    void readDatagramBatches();
+
+    // Publish and reset the batch statistics
+    void reportBatchStats();
+
 private:
+    // Open the raw socket used by batched mode
+    bool openBatchedSocket(const QString &address, quint16 port);
+
+    // Apply the receive buffer, busy poll, drop counter and timestamp options
+    void configureBatchedSocket();
+
     QUdpSocket *mrecv;       // UDP socket for receiving data
-    QProcess *tsharkProcess; // Tshark process for network monitoring
-    QTimer *bufferCleaner;   // Timer to periodically clear the buffer
+    QTimer *statsTimer;      // Timer to publish batch statistics
+    PacketRing *ring;        // Destination for received datagrams
+    quint32 sourceFilter;    // Accepted sender, 0 for any
+    bool sharePort;          // Set SO_REUSEPORT before binding
+    int receiveBufferBytes;  // 0 keeps the system default
+    bool forceReceiveBuffer;
+    int busyPollMicroseconds;
+
+    // Batched receive state
+    ReceiveMode receiveMode;
+    int batchSize;
+    int batchFd;                        // Raw socket descriptor, -1 when unused
+    QSocketNotifier *batchNotifier;     // Read notifier for batchFd
+    std::vector<PacketSlot> discardSlots; // Scratch slab for dropped datagrams (ring full, or queued before connect())
+    std::vector<PacketSlot *> batchSlots; // Ring slots reserved for the current batch
+#ifdef Q_OS_LINUX
+    std::vector<mmsghdr> batchHeaders;
+    std::vector<iovec> batchIovecs;
+    std::vector<sockaddr_in> batchAddresses;  // Sender of each batch entry
+    std::vector<quint64> batchControl;        // Receive timestamp and drop count of each entry
+#endif
+
+    // Batch statistics for the current reporting interval
+    quint64 statSyscalls;
+    quint64 statPackets;
+    quint64 reportedOverflow;
+
+    // Kernel drop counter: the socket's cumulative 32-bit SO_RXQ_OVFL value
+    // last seen, widened into a 64-bit total
+    quint32 lastKernelDrops;
+    std::atomic<quint64> socketOverflow;
+    quint64 reportedSocketOverflow;
 };
 
 #endif // UDP_RECEIVER_H
-
@@ -0,0 +1,164 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: VideoRecorder.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+This file implements the asynchronous video
+recorder. Published frames are converted to BGR
+into a bounded queue of preallocated slots and
+encoded on a dedicated thread, so recording no
+longer stalls reassembly or the display. Frames the
+recorder cannot keep up with are counted apart from
+frames lost on the network.
+===================================================
+*/
+
+#include "VideoRecorder.h"
+#include "FramePool.h"
+#include <QDebug>
+#include <QMutexLocker>
+
+VideoRecorder::VideoRecorder(QObject *parent)
+    : QThread(parent),
+      queueHead(0),
+      queueCount(0),
+      converting(0),
+      stopping(false),
+      queueDepth(8),
+      policy(DropWhenFull) {
+}
+
+VideoRecorder::~VideoRecorder() {
+    close();
+}
+
+void VideoRecorder::setQueueDepth(int depth) {
+    QMutexLocker lock(&queueMutex);
+    queueDepth = qBound(1, depth, 256);
+}
+
+void VideoRecorder::setQueuePolicy(QueuePolicy queuePolicy) {
+    QMutexLocker lock(&queueMutex);
+    policy = queuePolicy;
+}
+
+bool VideoRecorder::open(const QString &fileName, int fourcc, double fps, int width, int height) {
+    close();
+
+    try {
+        writer.open(fileName.toStdString(), fourcc, fps, cv::Size(width, height));
+    } catch (const cv::Exception &e) {
+        qWarning() << "OpenCV exception while opening VideoWriter:" << e.what();
+        return false;
+    }
+    if (!writer.isOpened()) {
+        return false;
+    }
+
+    // All conversion targets are allocated here, never per frame
+    QMutexLocker lock(&queueMutex);
+    slotFrames.assign(queueDepth, cv::Mat());
+    freeSlots.clear();
+    for (int i = 0; i < queueDepth; ++i) {
+        slotFrames[i].create(height, width, CV_8UC3);
+        freeSlots.push_back(i);
+    }
+    queuedSlots.assign(queueDepth, 0);
+    queueHead = 0;
+    queueCount = 0;
+    converting = 0;
+    stopping = false;
+    written = 0;
+    dropped = 0;
+    lock.unlock();
+
+    start();
+    accepting.store(true, std::memory_order_release);
+    return true;
+}
+
+void VideoRecorder::close() {
+    {
+        QMutexLocker lock(&queueMutex);
+        accepting.store(false, std::memory_order_release);
+        // Let frames being converted right now reach the queue
+        while (converting > 0) {
+            slotFreed.wait(&queueMutex);
+        }
+        stopping = true;
+        frameQueued.wakeAll();
+        slotFreed.wakeAll();
+    }
+
+    wait();  // The encoder thread empties the queue before it exits
+
+    if (writer.isOpened()) {
+        writer.release();
+        qDebug() << "Recording closed:" << written.load() << "frames written," << dropped.load() << "dropped by the recorder.";
+    }
+}
+
+bool VideoRecorder::enqueue(const FrameBuffer &frame) {
+    int slot = -1;
+    {
+        QMutexLocker lock(&queueMutex);
+        if (!accepting.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        while (freeSlots.empty()) {
+            if (policy == DropWhenFull || stopping) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            slotFreed.wait(&queueMutex);
+            if (!accepting.load(std::memory_order_relaxed)) {
+                return false;
+            }
+        }
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        converting++;
+    }
+
+    // Single pass from the pool buffer into the queue slot, outside the lock
+    cv::Mat rgb(frame.height(), frame.width(), CV_8UC3, const_cast<quint8 *>(frame.constBits()), frame.bytesPerLine());
+    cv::cvtColor(rgb, slotFrames[slot], cv::COLOR_RGB2BGR);
+
+    QMutexLocker lock(&queueMutex);
+    queuedSlots[(queueHead + queueCount) % static_cast<int>(queuedSlots.size())] = slot;
+    queueCount++;
+    converting--;
+    frameQueued.wakeOne();
+    if (converting == 0) {
+        slotFreed.wakeAll();  // close() may be waiting for conversions to finish
+    }
+    return true;
+}
+
+void VideoRecorder::run() {
+    for (;;) {
+        int slot;
+        {
+            QMutexLocker lock(&queueMutex);
+            while (queueCount == 0 && !stopping) {
+                frameQueued.wait(&queueMutex);
+            }
+            if (queueCount == 0) {
+                return;  // Stopping and nothing left to write
+            }
+            slot = queuedSlots[queueHead];
+            queueHead = (queueHead + 1) % static_cast<int>(queuedSlots.size());
+            queueCount--;
+        }
+
+        writer.write(slotFrames[slot]);
+        written.fetch_add(1, std::memory_order_relaxed);
+
+        QMutexLocker lock(&queueMutex);
+        freeSlots.push_back(slot);
+        slotFreed.wakeAll();  // Shared with close(), so wake every waiter
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef VIDEO_RECORDER_H
+#define VIDEO_RECORDER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QString>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <vector>
+
+class FrameBuffer;
+
+// Video recording stage with its own encoder thread. Frames are converted
+// RGB -> BGR in one pass straight from the pool buffer into a preallocated
+// queue slot; the encoder thread writes queued slots to the file, so a slow
+// encoder never holds up reassembly beyond what the queue policy allows.
+class VideoRecorder : public QThread {
+    Q_OBJECT
+public:
+    enum QueuePolicy {
+        DropWhenFull,   // Discard the new frame when every slot is queued
+        BlockWhenFull   // Wait for the encoder to free a slot
+    };
+
+    explicit VideoRecorder(QObject *parent = nullptr);
+    ~VideoRecorder();
+
+    // Queue settings, applied by the next open()
+    void setQueueDepth(int depth);
+    void setQueuePolicy(QueuePolicy policy);
+
+    // Open the file and start the encoder thread
+    bool open(const QString &fileName, int fourcc, double fps, int width, int height);
+
+    // Write out every queued frame, stop the encoder thread and close the file
+    void close();
+
+    bool isOpen() const { return accepting.load(std::memory_order_acquire); }
+
+    // Convert and queue one frame (reassembly thread); false if it was dropped
+    bool enqueue(const FrameBuffer &frame);
+
+    // Counters since the last open()
+    quint64 writtenFrames() const { return written.load(std::memory_order_relaxed); }
+    quint64 droppedFrames() const { return dropped.load(std::memory_order_relaxed); }
+
+protected:
+    void run() override;
+
+private:
+    // Guards the slot lists and the stop flag
+    QMutex queueMutex;
+    QWaitCondition frameQueued;
+    QWaitCondition slotFreed;
+
+    std::vector<cv::Mat> slotFrames;  // Preallocated BGR frames
+    std::vector<int> freeSlots;       // Slots ready to be filled
+    std::vector<int> queuedSlots;     // Ring of filled slots, oldest at queueHead
+    int queueHead;
+    int queueCount;
+    int converting;                   // Slots claimed by enqueue() but not queued yet
+    bool stopping;
+
+    int queueDepth;
+    QueuePolicy policy;
+
+    cv::VideoWriter writer;           // Only touched by the encoder thread while it runs
+    std::atomic<bool> accepting{false};
+    std::atomic<quint64> written{0};
+    std::atomic<quint64> dropped{0};
+};
+
+#endif // VIDEO_RECORDER_H
@@ -1,135 +1,211 @@
 #include "YoloProcessor.h"
+#include <QCoreApplication>
 #include <QDebug>
-#include <QElapsedTimer>
-#include <QtConcurrent>
-#include <QBuffer>
-#include <QImageReader>
 #include <QDir>
-
-YoloProcessor::YoloProcessor(QObject *parent) : QObject(parent) {
-    net = cv::dnn::readNetFromONNX("D:/yolov8n_416.onnx");
-    net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
-    net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
-    frameBuffer = QImage(400, 400, QImage::Format_RGB888);
-    frameBuffer.fill(Qt::black);
-}
-
-void YoloProcessor::addPixel(int x, int y, uchar r, uchar g, uchar b) {
-    if (x >= 0 && x < frameBuffer.width() && y >= 0 && y < frameBuffer.height()) {
-        frameBuffer.setPixel(x, y, qRgb(r, g, b));
+#include <QMutexLocker>
+
+YoloProcessor::YoloProcessor(const FramePool *pool, const DetectionSettings &settings, QObject *parent)
+    : QObject(parent),
+      pool(pool),
+      settings(settings),
+      stopping(false),
+      lastTaken(0),
+      offered(0),
+      accumulatedChange(0.0f),
+      haveEmitted(false) {
+    // Split the cores between the instances so they do not oversubscribe the
+    // CPU. OpenCV's thread count is process wide, so this is a per-network
+    // budget only because every network uses the same value.
+    int budget = settings.threadsPerInstance;
+    if (budget == 0) {
+        budget = qMax(1, QThread::idealThreadCount() / settings.instances);
+    }
+    if (settings.instances > 1 || settings.threadsPerInstance > 0) {
+        cv::setNumThreads(budget);
     }
-}
 
-void YoloProcessor::frameReady() {
-    // qDebug() << "[YOLO] frameReady() called!";
+    const QString model = QDir(QCoreApplication::applicationDirPath()).absoluteFilePath(settings.model);
+    for (int i = 0; i < settings.instances; ++i) {
+        cv::dnn::Net net;
+        try {
+            net = cv::dnn::readNetFromONNX(model.toStdString());
+            net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+            net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        } catch (const cv::Exception &e) {
+            qWarning() << "[YOLO] Failed to load model" << model << ":" << e.what();
+            break;
+        }
+        if (net.empty()) {
+            qWarning() << "[YOLO] Model is empty:" << model;
+            break;
+        }
+        workers.emplace_back(new YoloWorker(this, net, settings.inputSize));
+    }
 
-    if (processing.exchange(true)) {
-        qDebug() << "[YOLO] Already processing, skipping...";
-        return;
+    for (const std::unique_ptr<YoloWorker> &worker : workers) {
+        worker->start();
     }
 
-    QtConcurrent::run([this]() {
-        this->runInference();
-    });
+    if (!workers.empty()) {
+        qDebug() << "[YOLO] Loaded model" << model << "into" << workers.size() << "instances with"
+                 << budget << "threads each";
+    }
 }
 
-// yolo inference
-void YoloProcessor::runInference() {
-//    qDebug() << "[YOLO] runInference() STARTED!";
-//    qDebug() << "[YOLO] Running inference on thread:" << QThread::currentThread();
-
-    QImage localFrame;
+YoloProcessor::~YoloProcessor() {
     {
-        QMutexLocker lock(&bufferMutex);
-        localFrame = frameBuffer.copy();
+        QMutexLocker locker(&lock);
+        stopping = true;
+        frameAvailable.wakeAll();
     }
 
-    if (localFrame.isNull()) {
-//        qDebug() << "[YOLO] ERROR: FrameBuffer is null!";
-        processing = false;
-        return;
+    // Running inferences finish first; their results are still emitted
+    for (const std::unique_ptr<YoloWorker> &worker : workers) {
+        worker->wait();
     }
+}
 
-    // **转换 QImage -> OpenCV Mat**
-    cv::Mat mat(localFrame.height(), localFrame.width(), CV_8UC3,
-                const_cast<uchar*>(localFrame.bits()), localFrame.bytesPerLine());
-
-    //  ** BGR -> RGB**
-    cv::cvtColor(mat, mat, cv::COLOR_RGB2BGR);
-
-    cv::Mat blob;
-    cv::Size inputSize(416, 416);
-    cv::dnn::blobFromImage(mat, blob, 1 / 255.0, inputSize, cv::Scalar(), true, false);
-
-    // qDebug() << "[YOLO] OpenCV blob size:" << blob.size;
-
-    net.setInput(blob);
-    std::vector<cv::Mat> outputs;
-    net.forward(outputs);
-
-    cv::Mat output = outputs[0].reshape(1, 5).t();  // (3549, 5)
-
-    // qDebug() << "[YOLO] Inference completed. Parsing results...";
-
-    std::vector<cv::Rect> boxes;
-    std::vector<float> scores;
-
-    for (int i = 0; i < output.rows; i++) {
-        float* data = output.ptr<float>(i);  // 直接取出每一行数据
-        float cx = data[0];
-        float cy = data[1];
-        float w = data[2];
-        float h = data[3];
-        float score = data[4];
-
-        if (score < 0.85) continue;
+bool YoloProcessor::isReady() const {
+    return !workers.empty();
+}
 
-        int x1 = std::max(0, std::min(mat.cols, static_cast<int>(cx - w / 2)));
-        int y1 = std::max(0, std::min(mat.rows, static_cast<int>(cy - h / 2)));
-        int x2 = std::max(0, std::min(mat.cols, static_cast<int>(cx + w / 2)));
-        int y2 = std::max(0, std::min(mat.rows, static_cast<int>(cy + h / 2)));
+bool YoloProcessor::isProcessing() const {
+    return busy.load() > 0;
+}
 
-        boxes.push_back(cv::Rect(x1, y1, x2 - x1, y2 - y1));
-        scores.push_back(score);
+void YoloProcessor::frameReady() {
+    if (workers.empty()) {
+        return;
     }
 
-    std::vector<int> indices;
-    cv::dnn::NMSBoxes(boxes, scores, 0.3, 0.5, indices);
-
-    std::vector<QRect> detectedBoxes;
-//    qDebug() << "[YOLO] Raw Boxes Before NMS:";
-//    for (size_t i = 0; i < boxes.size(); i++) {
-//        qDebug() << "Box:" << boxes[i].x << boxes[i].y << boxes[i].width << boxes[i].height
-//                 << "Score:" << scores[i];
-//    }
-
-    for (int i : indices) {
-        int original_x = boxes[i].x;
-        int original_y = boxes[i].y;
-        int original_width = boxes[i].width;
-        int original_height = boxes[i].height;
+    // Only the publishing thread calls this, so latest() is the frame just published
+    FrameHandle frame = pool->latest();
+    if (frame.isNull()) {
+        return;
+    }
 
-        int new_x = original_x * 2;
-        int new_y = original_y * 2;
-        int new_width = original_width * 2;
-        int new_height = original_height * 2;
+    // Taken under the lock so a worker between its check and its wait
+    // cannot miss the wakeup
+    QMutexLocker locker(&lock);
+    if (frame->sequence <= qMax(offered, lastTaken)) {
+        return;  // Already offered, or a worker took it before we got here
+    }
 
-        detectedBoxes.push_back(QRect(new_x, new_y, new_width, new_height));
+    if (settings.changeThreshold > 0.0f) {
+        accumulatedChange += float(frame->changedRows) / frame->height();
+
+        // Static scene: the frame gets the last detections, in order with
+        // the results still running. Not while an offered frame is still
+        // waiting for a worker: that one carries the change, and this frame
+        // replaces it as the newest frame to take.
+        if (haveEmitted && offered <= lastTaken && accumulatedChange < settings.changeThreshold) {
+            DetectionResult reuse;
+            reuse.sequence = frame->sequence;
+            reuse.frameId = frame->frameId;
+            reuse.frameSize = QSize(frame->width(), frame->height());
+            reuse.reused = true;
+            lastTaken = qMax(lastTaken, frame->sequence);
+            offered = frame->sequence;
+            inFlight.push_back(frame->sequence);
+            finishedEarly.emplace(frame->sequence, std::move(reuse));
+            skipped++;
+            emitInOrder();
+            return;
+        }
     }
 
+    offered = frame->sequence;
+    frameAvailable.wakeOne();
+}
 
-    qDebug() << "[YOLO] Detected" << detectedBoxes.size() << "objects";
+FrameHandle YoloProcessor::takeFrame() {
+    QMutexLocker locker(&lock);
+    for (;;) {
+        if (stopping) {
+            return FrameHandle();
+        }
+
+        if (offered > lastTaken) {
+            FrameHandle frame = pool->latest();
+            if (!frame.isNull() && frame->sequence > lastTaken) {
+                // Frames published while every worker was busy are skipped
+                lastTaken = frame->sequence;
+                inFlight.push_back(lastTaken);
+                accumulatedChange = 0.0f;  // Counted again from the frame that runs
+                busy++;
+                return frame;
+            }
+        }
+
+        frameAvailable.wait(&lock);
+    }
+}
 
-    emit detectionFinished(detectedBoxes);
+void YoloProcessor::finish(DetectionResult &&result) {
+    QMutexLocker locker(&lock);
+    busy--;
+    runs++;
+    finishedEarly.emplace(result.sequence, std::move(result));
+    emitInOrder();
+}
 
-    processing = false;
-    // qDebug() << "[YOLO] Processing flag reset. Ready for next frame.";
+void YoloProcessor::emitInOrder() {
+    // Frame IDs wrap, so order by the pool's sequence, which follows them.
+    // Emitting under the lock keeps the queued signals in that order.
+    while (!inFlight.empty()) {
+        auto done = finishedEarly.find(inFlight.front());
+        if (done == finishedEarly.end()) {
+            break;  // The oldest frame is still running
+        }
+        DetectionResult &result = done->second;
+        if (result.reused) {
+            result.detections = lastDetections;
+        } else {
+            lastDetections = result.detections;
+            haveEmitted = true;
+        }
+        emit detectionFinished(result);
+        finishedEarly.erase(done);
+        inFlight.pop_front();
+    }
 }
 
+YoloWorker::YoloWorker(YoloProcessor *processor, cv::dnn::Net net, int inputSize)
+    : processor(processor),
+      net(net),
+      context(inputSize) {
+}
 
-bool YoloProcessor::isProcessing() const {
-    bool status = processing.load();
-    // qDebug() << "[YOLO] isProcessing() called. Current status:" << status;
-    return status;
+// yolo inference
+void YoloWorker::run() {
+    for (;;) {
+        FrameHandle frame = processor->takeFrame();
+        if (frame.isNull()) {
+            return;
+        }
+        DetectionResult result = detect(frame);
+        frame.reset();  // Release the buffer before waiting for the others
+        processor->finish(std::move(result));
+    }
 }
 
+DetectionResult YoloWorker::detect(const FrameHandle &frame) {
+    DetectionResult result;
+    result.sequence = frame->sequence;
+    result.frameId = frame->frameId;
+    result.frameSize = QSize(frame->width(), frame->height());
+
+    // The input tensor and every scratch buffer are reused between frames
+    net.setInput(context.prepare(*frame));
+
+    // A failed frame still gets an (empty) result, or later ones would be
+    // held back waiting for it
+    try {
+        // A header over the network's own output blob, not a copy
+        const cv::Mat output = net.forward();
+        context.parse(output, processor->settings.scoreThreshold, processor->settings.nmsThreshold, result.detections);
+    } catch (const cv::Exception &e) {
+        qWarning() << "[YOLO] Inference failed:" << e.what();
+    }
+    return result;
+}
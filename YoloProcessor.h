@@ -2,39 +2,122 @@
 #define YOLOPROCESSOR_H
 
 #include <QObject>
+#include <QMetaType>
+#include <QMutex>
+#include <QRect>
+#include <QSize>
 #include <QThread>
-#include <QImage>
-#include <QByteArray>
+#include <QWaitCondition>
 #include <opencv2/opencv.hpp>
 #include <opencv2/dnn.hpp>
-#include <atomic>  
-#include <QMutex>
-#include <QElapsedTimer>
-#include <QtConcurrent>
-#include <QBuffer>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include "DetectionContext.h"
+#include "FramePool.h"
+#include "StreamConfig.h"
+
+// Detections for one frame, tagged with the frame they were computed on
+struct DetectionResult {
+    quint64 sequence = 0;   // FrameBuffer::sequence of the input frame
+    quint16 frameId = 0;    // Frame ID from the packet header
+    QSize frameSize;
+    std::vector<Detection> detections;
+    bool reused = false;    // Scene unchanged: the previous frame's detections
+};
+
+Q_DECLARE_METATYPE(DetectionResult)
+
+class YoloWorker;
 
+// Runs YOLO on frames published to a frame pool. Each of the configured
+// network instances has its own thread, its own DetectionContext and an
+// OpenCV thread budget; a free worker always takes the newest frame no other
+// worker has taken, reading it through a FrameHandle so it stays intact
+// while it is letterboxed into the network input. Results are emitted in
+// frame order even when a later frame finishes first. With a change
+// threshold set, frames are only offered to the workers once enough rows
+// (FrameBuffer::changedRows, summed since the last run) have changed; the
+// frames in between get the last result again.
 class YoloProcessor : public QObject {
 Q_OBJECT
 
 public:
-    explicit YoloProcessor(QObject *parent = nullptr);
+    YoloProcessor(const FramePool *pool, const DetectionSettings &settings, QObject *parent = nullptr);
+    ~YoloProcessor();
 
-    bool isProcessing() const; 
+    // False when no network instance could be loaded
+    bool isReady() const;
+
+    // True while any worker is running inference
+    bool isProcessing() const;
+
+    // Networks loaded and running
+    int instanceCount() const { return static_cast<int>(workers.size()); }
+
+    // Inferences run, and frames that reused the last result instead
+    quint64 completedRuns() const { return runs.load(std::memory_order_relaxed); }
+    quint64 skippedRuns() const { return skipped.load(std::memory_order_relaxed); }
 
 public slots:
-    void runInference(); 
-    void addPixel(int x, int y, uchar r, uchar g, uchar b);  
-    void frameReady();  
+    // A new frame was published (the publishing thread). Wakes a free worker,
+    // which takes the newest frame; with every worker busy the frame waits
+    // and is skipped if a newer one arrives first.
+    void frameReady();
 
 signals:
-    void detectionFinished(std::vector<QRect> boxes);  
+    void detectionFinished(const DetectionResult &result);
 
 private:
+    friend class YoloWorker;
+
+    // Newest frame not yet taken by any worker; blocks until there is one.
+    // Null once the processor is shutting down (worker threads).
+    FrameHandle takeFrame();
+
+    // Hand back a worker's result; emits it and any results it was holding
+    // back in frame order (worker threads)
+    void finish(DetectionResult &&result);
+
+    // Emit every finished result no older frame is waiting for (lock held)
+    void emitInOrder();
+
+    const FramePool *pool;
+    DetectionSettings settings;
+    std::vector<std::unique_ptr<YoloWorker>> workers;
+    std::atomic<int> busy{0};
+    std::atomic<quint64> runs{0};
+    std::atomic<quint64> skipped{0};
+
+    // Scheduling state, guarded by lock
+    QMutex lock;
+    QWaitCondition frameAvailable;
+    bool stopping;
+    quint64 lastTaken;                                // Newest sequence handed to a worker
+    quint64 offered;                                  // Newest sequence workers may take
+    float accumulatedChange;                          // Changed rows / height since a worker last took a frame
+    bool haveEmitted;
+    std::vector<Detection> lastDetections;            // Reused while the scene is static
+    std::deque<quint64> inFlight;                     // Taken sequences, oldest first
+    std::map<quint64, DetectionResult> finishedEarly; // Done but waiting for an older frame
+};
+
+// One network instance and the thread that runs it
+class YoloWorker : public QThread {
+public:
+    YoloWorker(YoloProcessor *processor, cv::dnn::Net net, int inputSize);
+
+protected:
+    void run() override;
+
+private:
+    DetectionResult detect(const FrameHandle &frame);
+
+    YoloProcessor *processor;
     cv::dnn::Net net;
-    QImage frameBuffer;  
-    QByteArray lastFrameJpg;  
-    std::atomic<bool> processing{false};  
-    QMutex bufferMutex;
+    DetectionContext context;
 };
 
 #endif // YOLOPROCESSOR_H
@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    marker_bench.pro \
+    pipeline_bench.pro \
+    rgb565_bench.pro
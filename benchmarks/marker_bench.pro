@@ -0,0 +1,16 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = marker_bench
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    marker_bench.cpp \
+    ../PacketClassifier.cpp
+
+HEADERS += \
+    ../PacketClassifier.h
@@ -0,0 +1,573 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: pipeline_bench.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+Benchmark suite for the receive -> reassemble ->
+decode -> display pipeline. Every stage is fed
+synthetic 400x400 frames in isolation (datagram
+read, marker classification, line placement,
+RGB565 decode, missing-row concealment, display
+scaling, detector pre- and post-processing, video
+recording), then the whole chain
+runs end to end through the packet ring and drain
+thread at a paced packet rate to measure frame
+latency percentiles. Results are written as JSON
+so runs can be compared between releases.
+Usage: pipeline_bench [--frames N] [--rate pps] [--loss p] [-o results.json]
+===================================================
+*/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QtEndian>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "DetectionContext.h"
+#include "DisplayScaler.h"
+#include "FramePool.h"
+#include "FrameReassembler.h"
+#include "PacketClassifier.h"
+#include "PacketDrainThread.h"
+#include "PacketRing.h"
+#include "Rgb565Decoder.h"
+#include "Rgb565ToneTable.h"
+#include "RowConcealer.h"
+#include "StreamConfig.h"
+#include "VideoRecorder.h"
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Keeps the optimiser from discarding a benchmark result
+volatile quint64 sink = 0;
+
+qint64 steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Synthetic datagrams for one frame: start marker, one per line, end marker
+class SyntheticStream {
+public:
+    explicit SyntheticStream(const StreamDescriptor &stream) : stream(stream) {
+        std::mt19937 random(42);
+        lines.resize(static_cast<size_t>(stream.height) * stream.bytesPerLine);
+        for (char &byte : lines) {
+            // Keep line payloads away from the marker bytes
+            byte = static_cast<char>(random() % 0xA0);
+        }
+    }
+
+    int packetsPerFrame() const { return stream.height + 2; }
+
+    // Write packet n of frameId to out, returns its size
+    int packet(quint16 frameId, int n, char *out) const {
+        memset(out, 0, stream.headerSize);
+        qToBigEndian<quint16>(frameId, out + stream.frameIdOffset);
+        char *payload = out + stream.headerSize;
+        if (n == 0 || n == packetsPerFrame() - 1) {
+            memset(payload, n == 0 ? stream.startMarker : stream.endMarker, stream.bytesPerLine);
+        } else {
+            qToBigEndian<quint16>(static_cast<quint16>(n - 1), out + stream.lineIndexOffset);
+            memcpy(payload, lines.data() + static_cast<size_t>(n - 1) * stream.bytesPerLine, stream.bytesPerLine);
+        }
+        return stream.packetSize();
+    }
+
+    const char *linePayload(int line) const { return lines.data() + static_cast<size_t>(line) * stream.bytesPerLine; }
+
+    // All packets of one frame back to back, packetSize() bytes apart
+    std::vector<char> frame(quint16 frameId) const {
+        std::vector<char> packets(static_cast<size_t>(packetsPerFrame()) * stream.packetSize());
+        for (int n = 0; n < packetsPerFrame(); ++n) {
+            packet(frameId, n, packets.data() + static_cast<size_t>(n) * stream.packetSize());
+        }
+        return packets;
+    }
+
+private:
+    StreamDescriptor stream;
+    std::vector<char> lines;
+};
+
+QJsonObject stageResult(const QString &name, const QString &unit, quint64 items, qint64 nanoseconds) {
+    QJsonObject result;
+    result["stage"] = name;
+    result["unit"] = unit;
+    result["items"] = static_cast<double>(items);
+    result["totalMs"] = nanoseconds / 1e6;
+    result["nsPerItem"] = items ? double(nanoseconds) / items : 0.0;
+    result["itemsPerSecond"] = nanoseconds ? items * 1e9 / nanoseconds : 0.0;
+    return result;
+}
+
+QJsonObject benchReceive(const SyntheticStream &source, const StreamDescriptor &stream, int frames) {
+#ifdef Q_OS_LINUX
+    // Loopback socket pair; packets are sent in batches outside the timed region
+    const int batch = 64;
+    int rx = ::socket(AF_INET, SOCK_DGRAM, 0);
+    int tx = ::socket(AF_INET, SOCK_DGRAM, 0);
+    int buffer = 4 * 1024 * 1024;
+    ::setsockopt(rx, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    ::bind(rx, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    ::getsockname(rx, reinterpret_cast<sockaddr *>(&addr), &length);
+
+    std::vector<char> packets = source.frame(0);
+    std::vector<mmsghdr> sendHeaders(batch), recvHeaders(batch);
+    std::vector<iovec> sendIovecs(batch), recvIovecs(batch);
+    std::vector<PacketSlot *> ringSlots(batch);
+    for (int i = 0; i < batch; ++i) {
+        memset(&sendHeaders[i], 0, sizeof(mmsghdr));
+        memset(&recvHeaders[i], 0, sizeof(mmsghdr));
+        sendHeaders[i].msg_hdr.msg_iov = &sendIovecs[i];
+        sendHeaders[i].msg_hdr.msg_iovlen = 1;
+        sendHeaders[i].msg_hdr.msg_name = &addr;
+        sendHeaders[i].msg_hdr.msg_namelen = sizeof(addr);
+        recvHeaders[i].msg_hdr.msg_iov = &recvIovecs[i];
+        recvHeaders[i].msg_hdr.msg_iovlen = 1;
+        recvIovecs[i].iov_len = PacketSlot::Capacity;
+    }
+
+    PacketRing ring(4096);
+    const quint64 total = static_cast<quint64>(frames) * source.packetsPerFrame();
+    quint64 received = 0;
+    qint64 elapsed = 0;
+    int packetIndex = 0;
+
+    while (received < total) {
+        for (int i = 0; i < batch; ++i) {
+            sendIovecs[i].iov_base = packets.data() + static_cast<size_t>(packetIndex) * stream.packetSize();
+            sendIovecs[i].iov_len = stream.packetSize();
+            packetIndex = (packetIndex + 1) % source.packetsPerFrame();
+        }
+        int sent = ::sendmmsg(tx, sendHeaders.data(), batch, 0);
+        if (sent <= 0) {
+            break;
+        }
+
+        // Timed: the receiver's recvmmsg() into ring slots and commit
+        const qint64 start = steadyNs();
+        int wanted = ring.acquire(ringSlots.data(), sent);
+        for (int i = 0; i < wanted; ++i) {
+            recvIovecs[i].iov_base = ringSlots[i]->data;
+        }
+        int got = ::recvmmsg(rx, recvHeaders.data(), wanted, MSG_DONTWAIT, nullptr);
+        if (got > 0) {
+            for (int i = 0; i < got; ++i) {
+                ringSlots[i]->size = static_cast<qint32>(recvHeaders[i].msg_len);
+            }
+            ring.commit(got);
+            received += got;
+        }
+        elapsed += steadyNs() - start;
+
+        ring.drain([](const PacketSlot &slot) { sink += slot.size; }, batch);
+        if (got <= 0) {
+            break;
+        }
+    }
+
+    ::close(rx);
+    ::close(tx);
+    QJsonObject result = stageResult("datagramRead", "packet", received, elapsed);
+    result["batch"] = batch;
+    return result;
+#else
+    Q_UNUSED(source);
+    Q_UNUSED(stream);
+    Q_UNUSED(frames);
+    QJsonObject result = stageResult("datagramRead", "packet", 0, 0);
+    result["skipped"] = "recvmmsg() needs Linux";
+    return result;
+#endif
+}
+
+QJsonObject benchClassify(const SyntheticStream &source, const StreamDescriptor &stream, int frames) {
+    std::vector<char> packets = source.frame(0);
+    const int payloadSize = stream.bytesPerLine;
+
+    const qint64 start = steadyNs();
+    quint64 markers = 0;
+    for (int f = 0; f < frames; ++f) {
+        for (int n = 0; n < source.packetsPerFrame(); ++n) {
+            const quint8 *payload = reinterpret_cast<const quint8 *>(packets.data()) + static_cast<size_t>(n) * stream.packetSize() + stream.headerSize;
+            markers += PacketClassifier::classify(payload, payloadSize, stream.startMarker, stream.endMarker) != PacketClassifier::LinePacket;
+        }
+    }
+    const qint64 elapsed = steadyNs() - start;
+    sink += markers;
+    return stageResult("markerClassification", "packet", static_cast<quint64>(frames) * source.packetsPerFrame(), elapsed);
+}
+
+QJsonObject benchDecode(const SyntheticStream &source, const StreamDescriptor &stream, int frames) {
+    std::vector<quint8> row(static_cast<size_t>(stream.width) * 3);
+
+    const qint64 start = steadyNs();
+    for (int f = 0; f < frames; ++f) {
+        for (int line = 0; line < stream.height; ++line) {
+            Rgb565Decoder::decodeLine(reinterpret_cast<const quint8 *>(source.linePayload(line)), row.data(), stream.pixelsPerLine());
+        }
+    }
+    const qint64 elapsed = steadyNs() - start;
+    sink += row[0];
+
+    QJsonObject result = stageResult("rgb565Decode", "line", static_cast<quint64>(frames) * stream.height, elapsed);
+    result["kernel"] = Rgb565Decoder::kernelName(Rgb565Decoder::bestKernel());
+    return result;
+}
+
+QJsonObject benchToneDecode(const SyntheticStream &source, const StreamDescriptor &stream, int frames) {
+    // Decode and tone mapping through one table lookup per pixel
+    Rgb565ToneTable table;
+    std::vector<quint8> row(static_cast<size_t>(stream.width) * 3);
+
+    const qint64 start = steadyNs();
+    for (int f = 0; f < frames; ++f) {
+        for (int line = 0; line < stream.height; ++line) {
+            table.decodeLine(reinterpret_cast<const quint8 *>(source.linePayload(line)), row.data(), stream.pixelsPerLine());
+        }
+    }
+    const qint64 elapsed = steadyNs() - start;
+    sink += row[0];
+
+    return stageResult("rgb565ToneLookupDecode", "line", static_cast<quint64>(frames) * stream.height, elapsed);
+}
+
+QJsonObject benchReassemble(const SyntheticStream &source, const StreamDescriptor &stream, int frames) {
+    // Line placement plus the decode that happens as each line lands
+    FramePool pool(stream.width, stream.height, 6);
+    FrameReassembler reassembler(stream, &pool);
+    reassembler.setFrameHandler([&pool](FrameReassembler::Frame &frame, bool) {
+        pool.publish(frame.buffer);
+        frame.buffer = nullptr;
+    });
+
+    std::vector<std::vector<char>> packets;
+    for (quint16 id = 0; id < 4; ++id) {
+        packets.push_back(source.frame(id));
+    }
+
+    const qint64 start = steadyNs();
+    for (int f = 0; f < frames; ++f) {
+        // Frame IDs must advance, so patch the header of a prebuilt frame
+        std::vector<char> &frame = packets[f % packets.size()];
+        for (int n = 0; n < source.packetsPerFrame(); ++n) {
+            char *packet = frame.data() + static_cast<size_t>(n) * stream.packetSize();
+            qToBigEndian<quint16>(static_cast<quint16>(f), packet + stream.frameIdOffset);
+            reassembler.addPacket(packet, stream.packetSize());
+        }
+    }
+    reassembler.flush();
+    const qint64 elapsed = steadyNs() - start;
+
+    QJsonObject result = stageResult("linePlacementAndDecode", "packet", static_cast<quint64>(frames) * source.packetsPerFrame(), elapsed);
+    result["framesComplete"] = static_cast<double>(reassembler.stats().framesComplete);
+    return result;
+}
+
+QJsonObject benchConceal(const StreamDescriptor &stream, int frames, double loss) {
+    FramePool pool(stream.width, stream.height, 4);
+    FrameBuffer *previous = pool.acquireWrite();
+    FrameBuffer *frame = pool.acquireWrite();
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<quint8> received(stream.height);
+    for (quint8 &row : received) {
+        row = uniform(random) >= loss;
+    }
+
+    quint64 missing = 0;
+    const qint64 start = steadyNs();
+    for (int f = 0; f < frames; ++f) {
+        ConcealmentResult result = RowConcealer::conceal(*frame, received.data(), stream.height, stream.width * 3, previous);
+        missing += result.missingRows;
+    }
+    const qint64 elapsed = steadyNs() - start;
+
+    pool.releaseWrite(previous);
+    pool.releaseWrite(frame);
+
+    QJsonObject result = stageResult("missingRowConcealment", "frame", frames, elapsed);
+    result["missingRowsPerFrame"] = frames ? double(missing) / frames : 0.0;
+    return result;
+}
+
+QJsonObject benchDisplay(const StreamDescriptor &stream, int frames, const QSize &target) {
+    // Same work as UdpFrameProcessor::paintEvent for a new frame each time:
+    // scale, flip and convert once, then blit onto an offscreen surface
+    FramePool pool(stream.width, stream.height, 3);
+    QImage surface(target, QImage::Format_RGB32);
+    DisplayScaler scaler;
+
+    const qint64 start = steadyNs();
+    for (int f = 0; f < frames; ++f) {
+        pool.publish(pool.acquireWrite());  // New sequence, so the scaler cache misses
+        FrameHandle frame = pool.latest();
+        const QImage &image = scaler.render(*frame, surface.size(), false, true);
+        QPainter painter(&surface);
+        painter.drawImage(scaler.placement().topLeft(), image);
+    }
+    const qint64 elapsed = steadyNs() - start;
+
+    QJsonObject result = stageResult("displayScaling", "frame", frames, elapsed);
+    result["targetWidth"] = target.width();
+    result["targetHeight"] = target.height();
+    return result;
+}
+
+QJsonObject benchDetection(const StreamDescriptor &stream, int frames) {
+    // Everything around the network: letterbox into the input tensor, then
+    // parse a YOLOv8 output with a handful of boxes above the threshold
+    const int inputSize = 416;
+    FramePool pool(stream.width, stream.height, 2);
+    pool.publish(pool.acquireWrite());
+    FrameHandle frame = pool.latest();
+
+    const int candidates = 3549;  // 52^2 + 26^2 + 13^2 anchors at 416
+    const int shape[] = { 1, 5, candidates };
+    cv::Mat output(3, shape, CV_32F, cv::Scalar(0));
+    float *rows = output.ptr<float>();
+    for (int i = 0; i < candidates; i += 500) {
+        rows[i] = rows[candidates + i] = 208.0f;
+        rows[2 * candidates + i] = rows[3 * candidates + i] = 40.0f + i % 7;
+        rows[4 * candidates + i] = 0.9f;
+    }
+
+    DetectionContext context(inputSize);
+    std::vector<Detection> detections;
+
+    const qint64 start = steadyNs();
+    for (int f = 0; f < frames; ++f) {
+        sink += context.prepare(*frame).ptr<float>()[0] > 0.0f;
+        context.parse(output, 0.85f, 0.5f, detections);
+    }
+    const qint64 elapsed = steadyNs() - start;
+    sink += detections.size();
+
+    QJsonObject result = stageResult("detectionPrePostProcessing", "frame", frames, elapsed);
+    result["inputSize"] = inputSize;
+    return result;
+}
+
+QJsonObject benchRecording(const StreamDescriptor &stream, int frames) {
+    FramePool pool(stream.width, stream.height, 3);
+    FrameBuffer *buffer = pool.acquireWrite();
+
+    VideoRecorder recorder;
+    recorder.setQueuePolicy(VideoRecorder::BlockWhenFull);  // Measure the encoder, never drop
+    const QString fileName = QDir::temp().absoluteFilePath("pipeline_bench.avi");
+    if (!recorder.open(fileName, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 30, stream.width, stream.height)) {
+        pool.releaseWrite(buffer);
+        QJsonObject result = stageResult("videoRecording", "frame", 0, 0);
+        result["skipped"] = "VideoWriter could not open an MJPG file";
+        return result;
+    }
+
+    // Enqueue cost is what the reassembly thread pays; total includes encoding
+    qint64 enqueueNs = 0;
+    const qint64 start = steadyNs();
+    for (int f = 0; f < frames; ++f) {
+        const qint64 before = steadyNs();
+        recorder.enqueue(*buffer);
+        enqueueNs += steadyNs() - before;
+    }
+    recorder.close();
+    const qint64 elapsed = steadyNs() - start;
+
+    pool.releaseWrite(buffer);
+    QFile::remove(fileName);
+
+    QJsonObject result = stageResult("videoRecording", "frame", recorder.writtenFrames(), elapsed);
+    result["enqueueNsPerFrame"] = frames ? double(enqueueNs) / frames : 0.0;
+    return result;
+}
+
+double percentile(const std::vector<qint64> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[qMin(index, sorted.size() - 1)] / 1000.0;
+}
+
+QJsonObject benchEndToEnd(const SyntheticStream &source, const StreamDescriptor &stream, int frames,
+                          double rate, double loss) {
+    PacketRing ring(4096);
+    FramePool pool(stream.width, stream.height, 6);
+    FrameReassembler reassembler(stream, &pool);
+
+    // Latency runs from the commit of the packet that completes a frame (or
+    // supersedes it) to the moment the frame is published
+    std::vector<qint64> latencies;
+    latencies.reserve(frames);
+    qint64 currentPacketNs = 0;
+    reassembler.setFrameHandler([&](FrameReassembler::Frame &frame, bool) {
+        pool.publish(frame.buffer);
+        frame.buffer = nullptr;
+        latencies.push_back(steadyNs() - currentPacketNs);
+    });
+
+    PacketDrainThread drain(&ring, [&](const PacketSlot &slot) {
+        currentPacketNs = slot.timestampNs;
+        reassembler.addPacket(slot.data, slot.size);
+    });
+    drain.start();
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double intervalNs = 1e9 / rate;
+    quint64 overflow = 0;
+
+    const qint64 start = steadyNs();
+    quint64 packetNumber = 0;
+    for (int f = 0; f < frames; ++f) {
+        for (int n = 0; n < source.packetsPerFrame(); ++n, ++packetNumber) {
+            const qint64 due = start + static_cast<qint64>(packetNumber * intervalNs);
+            while (steadyNs() < due) {
+            }
+            const bool isLine = n > 0 && n < source.packetsPerFrame() - 1;
+            if (isLine && loss > 0.0 && uniform(random) < loss) {
+                continue;
+            }
+
+            PacketSlot *slot = nullptr;
+            if (ring.acquire(&slot, 1) == 0) {
+                ring.recordOverflow(1);
+                overflow++;
+                continue;
+            }
+            slot->size = source.packet(static_cast<quint16>(f), n, slot->data);
+            slot->timestampNs = steadyNs();
+            ring.commit(1);
+            ring.notifyConsumer();
+        }
+    }
+
+    while (!ring.isEmpty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    drain.requestStop();
+    drain.wait();
+    // Frames still open in the reassembly window retire here, timed from the
+    // last packet, so every frame is counted and gets a latency sample
+    reassembler.flush();
+    const qint64 elapsed = steadyNs() - start;
+
+    std::sort(latencies.begin(), latencies.end());
+    QJsonObject latency;
+    latency["p50"] = percentile(latencies, 0.50);
+    latency["p90"] = percentile(latencies, 0.90);
+    latency["p99"] = percentile(latencies, 0.99);
+    latency["p999"] = percentile(latencies, 0.999);
+    latency["max"] = latencies.empty() ? 0.0 : latencies.back() / 1000.0;
+
+    const FrameReassembler::Stats &stats = reassembler.stats();
+    QJsonObject result = stageResult("endToEnd", "frame", latencies.size(), elapsed);
+    result["packetRate"] = rate;
+    result["loss"] = loss;
+    result["framesComplete"] = static_cast<double>(stats.framesComplete);
+    result["framesIncomplete"] = static_cast<double>(stats.framesIncomplete);
+    result["ringOverflow"] = static_cast<double>(overflow);
+    result["latencyUs"] = latency;
+    return result;
+}
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pipeline_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Per-stage and end-to-end benchmark of the frame pipeline, JSON output.");
+    parser.addHelpOption();
+    QCommandLineOption framesOption("frames", "Frames per stage.", "count", "500");
+    QCommandLineOption rateOption("rate", "End-to-end packet rate.", "pps", "24000");
+    QCommandLineOption lossOption("loss", "Line loss for concealment and end to end.", "p", "0.01");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Write JSON here instead of stdout.", "file");
+    QCommandLineOption configOption("config", "Stream config (udp_stream.ini) for the geometry.", "file");
+    parser.addOptions({framesOption, rateOption, lossOption, outputOption, configOption});
+    parser.process(app);
+
+    const int frames = qMax(parser.value(framesOption).toInt(), 1);
+    const double rate = qMax(parser.value(rateOption).toDouble(), 1.0);
+    const double loss = qBound(0.0, parser.value(lossOption).toDouble(), 1.0);
+    StreamDescriptor stream;
+    if (parser.isSet(configOption)) {
+        stream = loadStreamDescriptor(parser.value(configOption));
+    }
+    SyntheticStream source(stream);
+
+    QJsonArray stages;
+    stages.append(benchReceive(source, stream, frames));
+    stages.append(benchClassify(source, stream, frames));
+    stages.append(benchReassemble(source, stream, frames));
+    stages.append(benchDecode(source, stream, frames));
+    stages.append(benchToneDecode(source, stream, frames));
+    stages.append(benchConceal(stream, frames, loss));
+    stages.append(benchDisplay(stream, frames, QSize(800, 800)));
+    stages.append(benchDetection(stream, frames));
+    stages.append(benchRecording(stream, qMin(frames, 300)));
+
+    QJsonObject geometry;
+    geometry["width"] = stream.width;
+    geometry["height"] = stream.height;
+    geometry["bytesPerLine"] = stream.bytesPerLine;
+    geometry["headerSize"] = stream.headerSize;
+
+    QJsonObject report;
+    report["benchmark"] = "pipeline_bench";
+    report["formatVersion"] = 1;
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["qtVersion"] = qVersion();
+    report["cpu"] = QSysInfo::currentCpuArchitecture();
+    report["os"] = QSysInfo::prettyProductName();
+    report["framesPerStage"] = frames;
+    report["geometry"] = geometry;
+    report["stages"] = stages;
+    report["endToEnd"] = benchEndToEnd(source, stream, frames, rate, loss);
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Cannot write " << file.fileName() << "\n";
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
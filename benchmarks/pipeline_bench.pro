@@ -0,0 +1,57 @@
+QT       += core gui concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = pipeline_bench
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    pipeline_bench.cpp \
+    ../DetectionContext.cpp \
+    ../DisplayScaler.cpp \
+    ../FrameKernels.cpp \
+    ../FramePool.cpp \
+    ../FrameReassembler.cpp \
+    ../ImageAdjuster.cpp \
+    ../PacketClassifier.cpp \
+    ../PacketDrainThread.cpp \
+    ../PipelineMetrics.cpp \
+    ../Rgb565Decoder.cpp \
+    ../Rgb565ToneTable.cpp \
+    ../RowConcealer.cpp \
+    ../StreamConfig.cpp \
+    ../VideoRecorder.cpp
+
+HEADERS += \
+    ../DetectionContext.h \
+    ../DisplayScaler.h \
+    ../FrameKernels.h \
+    ../FramePool.h \
+    ../FrameReassembler.h \
+    ../ImageAdjuster.h \
+    ../PacketClassifier.h \
+    ../PacketDrainThread.h \
+    ../PacketRing.h \
+    ../PacketSlot.h \
+    ../PipelineMetrics.h \
+    ../Rgb565Decoder.h \
+    ../Rgb565ToneTable.h \
+    ../RowConcealer.h \
+    ../StreamConfig.h \
+    ../VideoRecorder.h
+
+# Same OpenCV build as the application
+win32 {
+    INCLUDEPATH += D:/OpenCV-MinGW-1/include
+    LIBS += -LD:/OpenCV-MinGW-1/x64/mingw/lib
+    LIBS += -lopencv_core348 \
+            -lopencv_imgproc348 \
+            -lopencv_videoio348 \
+            -lopencv_dnn348
+}
+unix {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += opencv4
+}
@@ -0,0 +1,16 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = rgb565_bench
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    rgb565_bench.cpp \
+    ../Rgb565Decoder.cpp
+
+HEADERS += \
+    ../Rgb565Decoder.h
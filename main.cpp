@@ -8,7 +8,8 @@ Language: C++ (Qt Framework)
 Description:
 This file implements the main entry point for the UDP-based
 image processing application. It initializes the UI components,
-sets up the UDP frame receiver, and connects various UI elements
+sets up one UDP frame receiver per configured camera
+stream, shown as a grid of tiles, and connects various UI elements
 to the image processing backend. The program creates a graphical
 interface that allows users to visualize incoming video data,
 adjust image processing parameters, capture snapshots, and
@@ -18,20 +19,40 @@ mechanism for seamless interaction between components.
 */
 
 #include <QApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QGridLayout>
 #include <QHBoxLayout>
 #include <QWidget>
+#include <QtMath>
+#include <vector>
 #include "UdpFrameProcessor.h"
 #include "ControlUI.h"
-#include "UdpReceiver.h"
+#include "StreamConfig.h"
 #include <QCoreApplication>
+#include <QStringList>
+
+// Forward one statistics signal of the stream at index to the control panel
+// while that stream is selected there
+template <typename... SignalArgs, typename... SlotArgs>
+static void connectStatistics(UdpFrameProcessor *tile, void (UdpFrameProcessor::*signal)(SignalArgs...),
+                              ControlUI *controlUI, void (ControlUI::*slot)(SlotArgs...), int index) {
+    QObject::connect(tile, signal, controlUI, [=](SignalArgs... args) {
+        if (controlUI->selectedStream() == index) {
+            (controlUI->*slot)(args...);
+        }
+    });
+}
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
 
-    UdpReceiver receiver;
-    //receiver.startTshark("以太网"); // Start Tshark
-    receiver.startTshark("Ethernet"); // Start Tshark
-    // receiver.startReceiving("192.168.1.102", 8080); // Receive UDP data
+    // Camera streams with their geometry, packet layout and listen address, next to the executable
+    const QString streamConfig = QCoreApplication::applicationDirPath() + "/udp_stream.ini";
+    if (!QFileInfo::exists(streamConfig)) {
+        qWarning() << "Stream configuration not found, using the default 400x400 stream:" << streamConfig;
+    }
+    std::vector<StreamSettings> streams = loadStreamList(streamConfig);
 
     // Create main container widget
     QWidget mainWidget;
@@ -42,31 +63,85 @@ int main(int argc, char *argv[]) {
     QHBoxLayout *mainLayout = new QHBoxLayout(&mainWidget);
     mainLayout->setSpacing(0);  // Set spacing to 0 to prevent the layout from expanding
 
-    // Set up UdpFrameProcessor (left side)
-    UdpFrameProcessor *videoDisplay = new UdpFrameProcessor(&mainWidget);
-    mainLayout->addWidget(videoDisplay, 1);
+    // One tile per stream (left side), as square a grid as possible. Every
+    // stream has its own receiver thread, drain thread and frame pool.
+    QGridLayout *tileLayout = new QGridLayout();
+    tileLayout->setSpacing(2);
+    const int columns = qCeil(qSqrt(double(streams.size())));
+    std::vector<UdpFrameProcessor *> videoDisplays;
+    for (size_t i = 0; i < streams.size(); ++i) {
+        UdpFrameProcessor *tile = new UdpFrameProcessor(streams[i], &mainWidget);
+        tile->setToolTip(streams[i].name);
+        tileLayout->addWidget(tile, int(i) / columns, int(i) % columns);
+        videoDisplays.push_back(tile);
+    }
+    mainLayout->addLayout(tileLayout, 1);
 
     // Set up ControlUI (right side)
     ControlUI *controlUI = new ControlUI(&mainWidget);
     mainLayout->addWidget(controlUI);
 
-    // Connect FPS signal to ControlUI
-    QObject::connect(videoDisplay, &UdpFrameProcessor::fpsChanged, controlUI, &ControlUI::onFPSChanged);
-
-    // Connect snapshotRequested signal to UdpFrameProcessor
-    QObject::connect(controlUI, &ControlUI::snapshotRequested, videoDisplay, &UdpFrameProcessor::saveSnapshot, Qt::QueuedConnection);
+    // The control panel shows the statistics of the stream selected in it;
+    // with [metrics] enabled every stream also writes its own file
+    QStringList streamNames;
+    for (const StreamSettings &stream : streams) {
+        streamNames << (stream.name.isEmpty() ? QString("camera1") : stream.name);
+    }
+    controlUI->setStreamNames(streamNames);
+    for (size_t i = 0; i < videoDisplays.size(); ++i) {
+        UdpFrameProcessor *tile = videoDisplays[i];
+        const int index = int(i);
+        connectStatistics(tile, &UdpFrameProcessor::fpsChanged, controlUI, &ControlUI::onFPSChanged, index);
+        connectStatistics(tile, &UdpFrameProcessor::receiveStatsChanged, controlUI, &ControlUI::onReceiveStatsChanged, index);
+        connectStatistics(tile, &UdpFrameProcessor::ringOverflowChanged, controlUI, &ControlUI::onRingOverflowChanged, index);
+        connectStatistics(tile, &UdpFrameProcessor::socketOverflowChanged, controlUI, &ControlUI::onSocketOverflowChanged, index);
+        connectStatistics(tile, &UdpFrameProcessor::concealmentChanged, controlUI, &ControlUI::onConcealmentChanged, index);
+        connectStatistics(tile, &UdpFrameProcessor::recorderStatsChanged, controlUI, &ControlUI::onRecorderStatsChanged, index);
+        connectStatistics(tile, &UdpFrameProcessor::metricsUpdated, controlUI, &ControlUI::onMetricsUpdated, index);
+    }
 
-    // Connect recordingRequested signal to UdpFrameProcessor
+    // Every stream records to its own file. They start and stop together and
+    // the button shows one state for all of them: if any stream fails to open
+    // its file, the streams that did start are stopped again
     QObject::connect(controlUI, &ControlUI::recordingRequested,
-                     videoDisplay, [=](const QString &directory, const QString &format) {
-        videoDisplay->toggleRecording(directory, format, 30);  // Only FPS parameters are passed, width and height are automatically obtained from the image resolution
+                     controlUI, [=](const QString &directory, const QString &format) {
+        bool started = true;
+        for (UdpFrameProcessor *tile : videoDisplays) {
+            // Only FPS parameters are passed, width and height are automatically obtained from the image resolution
+            if (!tile->startRecording(directory, format, 30)) {
+                started = false;
+                break;
+            }
+        }
+        if (!started) {
+            for (UdpFrameProcessor *tile : videoDisplays) {
+                tile->stopRecording();
+            }
+        }
+        controlUI->onRecordingStateChanged(started);
     });
+    QObject::connect(controlUI, &ControlUI::recordingStopRequested, controlUI, [=]() {
+        for (UdpFrameProcessor *tile : videoDisplays) {
+            tile->stopRecording();
+        }
+        controlUI->onRecordingStateChanged(false);
+    });
+
+    // Controls apply to every stream
+    for (UdpFrameProcessor *tile : videoDisplays) {
+        // Connect snapshotRequested signal to UdpFrameProcessor
+        QObject::connect(controlUI, &ControlUI::snapshotRequested, tile, &UdpFrameProcessor::saveSnapshot, Qt::QueuedConnection);
 
-    // Connect flipHorizontalRequested and flipVerticalRequested signals
-    QObject::connect(controlUI, &ControlUI::flipHorizontalRequested, videoDisplay, &UdpFrameProcessor::setFlipHorizontal, Qt::QueuedConnection);
-    QObject::connect(controlUI, &ControlUI::flipVerticalRequested, videoDisplay, &UdpFrameProcessor::setFlipVertical, Qt::QueuedConnection);
+        // Connect flipHorizontalRequested and flipVerticalRequested signals
+        QObject::connect(controlUI, &ControlUI::flipHorizontalRequested, tile, &UdpFrameProcessor::setFlipHorizontal, Qt::QueuedConnection);
+        QObject::connect(controlUI, &ControlUI::flipVerticalRequested, tile, &UdpFrameProcessor::setFlipVertical, Qt::QueuedConnection);
 
-    QObject::connect(videoDisplay, &UdpFrameProcessor::recordingStateChanged, controlUI, &ControlUI::onRecordingStateChanged);
+        // Connect the image adjustment sliders
+        QObject::connect(controlUI, &ControlUI::brightnessChanged, tile, &UdpFrameProcessor::setBrightness);
+        QObject::connect(controlUI, &ControlUI::gammaChanged, tile, &UdpFrameProcessor::setGamma);
+        QObject::connect(controlUI, &ControlUI::sharpnessChanged, tile, &UdpFrameProcessor::setSharpness);
+        QObject::connect(controlUI, &ControlUI::denoiseChanged, tile, &UdpFrameProcessor::setDenoise);
+    }
 
     // Set the layout for the main widget
     mainWidget.setLayout(mainLayout);
@@ -74,4 +149,3 @@ int main(int argc, char *argv[]) {
 
     return app.exec();
 }
-
@@ -2,7 +2,7 @@ QT       += core gui
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11
+CONFIG += c++17
 
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
@@ -17,24 +17,79 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
     ControlUI.cpp \
+    DetectionContext.cpp \
+    DisplayScaler.cpp \
+    DisplayScheduler.cpp \
+    FrameKernels.cpp \
+    FramePool.cpp \
+    FrameReassembler.cpp \
+    ImageAdjuster.cpp \
+    MetricsLog.cpp \
+    ObjectTracker.cpp \
+    PacketCapture.cpp \
+    PacketClassifier.cpp \
+    PacketDrainThread.cpp \
+    PipelineMetrics.cpp \
+    Rgb565Decoder.cpp \
+    Rgb565ToneTable.cpp \
+    RowConcealer.cpp \
+    StreamConfig.cpp \
     UdpFrameProcessor.cpp \
     UdpReceiver.cpp \
+    VideoRecorder.cpp \
+    YoloProcessor.cpp \
     main.cpp \
     mainwindow.cpp
 
 HEADERS += \
     ControlUI.h \
+    DetectionContext.h \
+    DisplayScaler.h \
+    DisplayScheduler.h \
+    FrameKernels.h \
+    FramePool.h \
+    FrameReassembler.h \
+    ImageAdjuster.h \
+    MetricsLog.h \
+    ObjectTracker.h \
+    PacketCapture.h \
+    PacketCaptureFormat.h \
+    PacketClassifier.h \
+    PacketDrainThread.h \
+    PacketRing.h \
+    PacketSlot.h \
+    PipelineMetrics.h \
+    Rgb565Decoder.h \
+    Rgb565ToneTable.h \
+    RowConcealer.h \
+    StreamConfig.h \
     UdpFrameProcessor.h \
     UdpReceiver.h \
+    VideoRecorder.h \
+    YoloProcessor.h \
     mainwindow.h
 
 FORMS += \
     mainwindow.ui
 
+DISTFILES += \
+    udp_stream.ini
+
+# main.cpp loads udp_stream.ini from the executable's directory, so copy it
+# there after linking; a shadow build would otherwise run on the defaults
+STREAM_INI_DIR = $$OUT_PWD
+win32:CONFIG(debug, debug|release): STREAM_INI_DIR = $$OUT_PWD/debug
+else:win32: STREAM_INI_DIR = $$OUT_PWD/release
+!isEmpty(DESTDIR): STREAM_INI_DIR = $$absolute_path($$DESTDIR, $$OUT_PWD)
+QMAKE_POST_LINK += $$QMAKE_COPY $$shell_quote($$shell_path($$PWD/udp_stream.ini)) $$shell_quote($$shell_path($$STREAM_INI_DIR))
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
+streamconfig.files = udp_stream.ini
+streamconfig.path = $$target.path
+!isEmpty(target.path): INSTALLS += streamconfig
 
 LIBS += -lWs2_32
 
@@ -54,6 +109,7 @@ LIBS += -lopencv_core348 \
         -lopencv_imgproc348 \
         -lopencv_highgui348 \
         -lopencv_imgcodecs348 \
-        -lopencv_videoio348
+        -lopencv_videoio348 \
+        -lopencv_dnn348
 
 
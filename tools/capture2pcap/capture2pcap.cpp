@@ -0,0 +1,141 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: capture2pcap.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+Converts raw packet capture segments written by the
+receiver into a single pcap file for Wireshark or
+tshark. Segments are ordered by their sequence
+number; every record becomes one LINKTYPE_RAW packet
+with synthesized IPv4 and UDP headers and the
+original nanosecond receive timestamp.
+Usage: capture2pcap <capture dir | segment files...> -o out.pcap
+===================================================
+*/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <QtEndian>
+#include <cstring>
+#include "PacketCaptureReader.h"
+
+using namespace PacketCaptureFormat;
+
+namespace {
+const quint32 kPcapMagicNanoseconds = 0xA1B23C4D;
+const quint32 kLinkTypeRaw = 101;   // Packets start with the IPv4 header
+const int kIpHeaderSize = 20;
+const int kUdpHeaderSize = 8;
+const int kMaxUdpPayload = 65535 - kIpHeaderSize - kUdpHeaderSize;
+
+QTextStream &err() {
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+quint16 ipChecksum(const uchar *header, int size) {
+    quint32 sum = 0;
+    for (int i = 0; i < size; i += 2) {
+        sum += (header[i] << 8) | header[i + 1];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<quint16>(~sum);
+}
+
+void writePcapHeader(QFile &out) {
+    uchar header[24];
+    qToLittleEndian<quint32>(kPcapMagicNanoseconds, header);
+    qToLittleEndian<quint16>(2, header + 4);        // Version 2.4
+    qToLittleEndian<quint16>(4, header + 6);
+    qToLittleEndian<qint32>(0, header + 8);         // UTC offset
+    qToLittleEndian<quint32>(0, header + 12);       // Timestamp accuracy
+    qToLittleEndian<quint32>(65535, header + 16);   // Snap length
+    qToLittleEndian<quint32>(kLinkTypeRaw, header + 20);
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+}
+
+void writePacket(QFile &out, const CaptureRecordHeader &record, const uchar *payload,
+                 quint32 destinationAddress, quint16 destinationPort, quint16 ipId) {
+    const quint32 length = qMin<quint32>(record.length, kMaxUdpPayload);
+    const quint32 packetLength = kIpHeaderSize + kUdpHeaderSize + length;
+
+    uchar header[16 + kIpHeaderSize + kUdpHeaderSize];
+    uchar *pcap = header;
+    uchar *ip = header + 16;
+    uchar *udp = ip + kIpHeaderSize;
+
+    const qint64 ns = record.timestampNs;
+    qToLittleEndian<quint32>(static_cast<quint32>(ns / 1000000000), pcap);
+    qToLittleEndian<quint32>(static_cast<quint32>(ns % 1000000000), pcap + 4);
+    qToLittleEndian<quint32>(packetLength, pcap + 8);   // Captured length
+    qToLittleEndian<quint32>(packetLength, pcap + 12);  // Original length
+
+    memset(ip, 0, kIpHeaderSize);
+    ip[0] = 0x45;                                       // IPv4, 5-word header
+    qToBigEndian<quint16>(static_cast<quint16>(packetLength), ip + 2);
+    qToBigEndian<quint16>(ipId, ip + 4);
+    ip[8] = 64;                                         // TTL
+    ip[9] = 17;                                         // UDP
+    qToBigEndian<quint32>(record.sourceAddress, ip + 12);
+    qToBigEndian<quint32>(destinationAddress, ip + 16);
+    qToBigEndian<quint16>(ipChecksum(ip, kIpHeaderSize), ip + 10);
+
+    qToBigEndian<quint16>(record.sourcePort, udp);
+    qToBigEndian<quint16>(destinationPort, udp + 2);
+    qToBigEndian<quint16>(static_cast<quint16>(kUdpHeaderSize + length), udp + 4);
+    qToBigEndian<quint16>(0, udp + 6);                  // No UDP checksum
+
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(payload), length);
+}
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("capture2pcap");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Convert raw packet capture segments to pcap.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Capture directory or .udpcap segment files.");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Output pcap file.", "file", "capture.pcap");
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    if (parser.positionalArguments().isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    PacketCaptureReader reader;
+    QStringList warnings;
+    reader.open(parser.positionalArguments(), &warnings);
+    for (const QString &warning : warnings) {
+        err() << warning << "\n";
+    }
+
+    QFile out(parser.value(outputOption));
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err() << "Cannot write " << out.fileName() << ": " << out.errorString() << "\n";
+        return 1;
+    }
+    writePcapHeader(out);
+
+    quint64 packets = 0;
+    quint16 ipId = 0;
+    reader.forEachRecord([&](const CaptureSegmentHeader &segment, const CaptureRecordHeader &record, const uchar *payload) {
+        writePacket(out, record, payload, segment.destinationAddress, segment.destinationPort, ipId++);
+        packets++;
+        return true;
+    });
+
+    QTextStream(stdout) << "Wrote " << packets << " packets from " << reader.segmentCount()
+                        << " segments to " << out.fileName() << "\n";
+    return 0;
+}
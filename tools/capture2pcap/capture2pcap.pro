@@ -0,0 +1,17 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = capture2pcap
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    capture2pcap.cpp \
+    ../../PacketCaptureReader.cpp
+
+HEADERS += \
+    ../../PacketCaptureFormat.h \
+    ../../PacketCaptureReader.h
@@ -0,0 +1,438 @@
+/*
+===================================================
+Created on: 16-10-2026
+Author: Chang Xu
+File: fpga_emulator.cpp
+Version: 1.0
+Language: C++ (Qt Framework)
+Description:
+Stand-in for the Xilinx board. Generates the exact
+wire format (start packet, one packet per line with
+the frame ID / line index header, end packet) and
+sends it with paced sendmmsg() at a fixed packet
+rate, optionally with random loss, burst loss and
+reordering. Can also replay capture segments at
+their original timing.
+Usage: fpga_emulator [--rate 24000] [--loss 0.01] ...
+       fpga_emulator --replay capture_dir [--speed 1]
+===================================================
+*/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QHostAddress>
+#include <QTextStream>
+#include <QtEndian>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "PacketCaptureReader.h"
+#include "PacketSlot.h"
+#include "StreamConfig.h"
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace {
+std::atomic<bool> stopRequested{false};
+
+QTextStream &out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+#ifdef Q_OS_LINUX
+void handleSignal(int) {
+    stopRequested = true;
+}
+
+qint64 monotonicNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<qint64>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// Sleep until deadline (CLOCK_MONOTONIC ns); the last stretch is spun for precision
+void sleepUntil(qint64 deadline) {
+    const qint64 spinNs = 200000;
+    qint64 now = monotonicNs();
+    if (deadline - now > spinNs) {
+        const qint64 wake = deadline - spinNs;
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(wake / 1000000000);
+        ts.tv_nsec = static_cast<long>(wake % 1000000000);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+    }
+    while (monotonicNs() < deadline) {
+    }
+}
+
+// Collects packets and sends them with one sendmmsg() per batch
+class BatchSender {
+public:
+    BatchSender(int fd, const sockaddr_in &target, int batchSize)
+        : fd(fd), target(target), packetSlots(batchSize), headers(batchSize), iovecs(batchSize), count(0),
+          sent(0), failed(0), syscalls(0) {
+        for (int i = 0; i < batchSize; ++i) {
+            memset(&headers[i], 0, sizeof(mmsghdr));
+            iovecs[i].iov_base = packetSlots[i].data;
+            headers[i].msg_hdr.msg_iov = &iovecs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+            headers[i].msg_hdr.msg_name = &this->target;
+            headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+    }
+
+    bool isFull() const { return count == static_cast<int>(packetSlots.size()); }
+    bool isEmpty() const { return count == 0; }
+
+    void add(const char *data, int size) {
+        size = qMin(size, static_cast<int>(PacketSlot::Capacity));
+        memcpy(packetSlots[count].data, data, size);
+        iovecs[count].iov_len = static_cast<size_t>(size);
+        count++;
+    }
+
+    void flush() {
+        int offset = 0;
+        while (offset < count) {
+            int result = ::sendmmsg(fd, headers.data() + offset, count - offset, 0);
+            syscalls++;
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                failed += count - offset;  // ENOBUFS and friends: the batch is lost
+                break;
+            }
+            sent += result;
+            offset += result;
+        }
+        count = 0;
+    }
+
+    quint64 sentCount() const { return sent; }
+    quint64 failedCount() const { return failed; }
+    quint64 syscallCount() const { return syscalls; }
+
+private:
+    int fd;
+    sockaddr_in target;
+    std::vector<PacketSlot> packetSlots;
+    std::vector<mmsghdr> headers;
+    std::vector<iovec> iovecs;
+    int count;
+    quint64 sent;
+    quint64 failed;
+    quint64 syscalls;
+};
+
+// Loss, burst loss and reordering applied to the generated packet sequence
+struct Impairments {
+    double loss = 0.0;          // Probability of dropping a packet
+    int burstEvery = 0;         // Drop burstLength packets every burstEvery packets (0 = off)
+    int burstLength = 0;
+    double reorder = 0.0;       // Probability of delaying a packet
+    int reorderDistance = 8;    // A delayed packet is sent up to this many packets later
+};
+
+struct DelayedPacket {
+    quint64 releaseAt;          // Packet index after which it is sent
+    std::vector<char> data;
+};
+
+class StreamGenerator {
+public:
+    StreamGenerator(const StreamDescriptor &stream, const Impairments &impairments, quint32 seed)
+        : stream(stream), impairments(impairments), random(seed), uniform(0.0, 1.0),
+          packetIndex(0), dropped(0), reordered(0) {
+        buildPattern();
+        packet.resize(stream.packetSize());
+    }
+
+    // Packets per frame: start, one per line, end
+    int packetsPerFrame() const { return stream.height + 2; }
+
+    // Emit packet number n (0-based) of frame frameId into sender
+    void emitPacket(quint16 frameId, int n, BatchSender &sender) {
+        const int payloadSize = stream.bytesPerLine;
+        memset(packet.data(), 0, stream.headerSize);
+        qToBigEndian<quint16>(frameId, packet.data() + stream.frameIdOffset);
+
+        if (n == 0 || n == packetsPerFrame() - 1) {
+            memset(packet.data() + stream.headerSize, n == 0 ? stream.startMarker : stream.endMarker, payloadSize);
+        } else {
+            const int line = n - 1;
+            qToBigEndian<quint16>(static_cast<quint16>(line), packet.data() + stream.lineIndexOffset);
+            // Scroll the pattern one row per frame so motion is visible
+            const int patternRow = (line + frameId) % stream.height;
+            memcpy(packet.data() + stream.headerSize, pattern.data() + patternRow * payloadSize, payloadSize);
+        }
+
+        submit(packet.data(), stream.packetSize(), sender);
+    }
+
+    // Send every packet still held back for reordering
+    void drain(BatchSender &sender) {
+        for (DelayedPacket &delayed : delayedPackets) {
+            sendNow(delayed.data.data(), static_cast<int>(delayed.data.size()), sender);
+        }
+        delayedPackets.clear();
+    }
+
+    quint64 droppedCount() const { return dropped; }
+    quint64 reorderedCount() const { return reordered; }
+
+private:
+    void buildPattern() {
+        // Vertical colour bars with a horizontal brightness ramp, big-endian RGB565
+        static const quint16 bars[8] = {0xFFFF, 0xFFE0, 0x07FF, 0x07E0, 0xF81F, 0xF800, 0x001F, 0x0000};
+        const int pixels = stream.bytesPerLine / 2;
+        pattern.resize(static_cast<size_t>(stream.height) * stream.bytesPerLine);
+        for (int y = 0; y < stream.height; ++y) {
+            for (int x = 0; x < pixels; ++x) {
+                quint16 colour = bars[(x * 8) / qMax(pixels, 1)];
+                if (y >= stream.height * 3 / 4) {
+                    const int level = (x * 31) / qMax(pixels - 1, 1);
+                    colour = static_cast<quint16>((level << 11) | ((level * 2) << 5) | level);
+                }
+                qToBigEndian<quint16>(colour, pattern.data() + (y * pixels + x) * 2);
+            }
+        }
+    }
+
+    void submit(const char *data, int size, BatchSender &sender) {
+        const quint64 index = packetIndex++;
+
+        const bool inBurst = impairments.burstEvery > 0
+                             && static_cast<int>(index % impairments.burstEvery) < impairments.burstLength;
+        if (inBurst || (impairments.loss > 0.0 && uniform(random) < impairments.loss)) {
+            dropped++;
+        } else if (impairments.reorder > 0.0 && uniform(random) < impairments.reorder) {
+            std::uniform_int_distribution<int> distance(1, qMax(impairments.reorderDistance, 1));
+            DelayedPacket delayed;
+            delayed.releaseAt = index + distance(random);
+            delayed.data.assign(data, data + size);
+            delayedPackets.push_back(std::move(delayed));
+            reordered++;
+        } else {
+            sendNow(data, size, sender);
+        }
+
+        // Release held-back packets whose turn has come
+        for (size_t i = 0; i < delayedPackets.size();) {
+            if (delayedPackets[i].releaseAt <= index) {
+                sendNow(delayedPackets[i].data.data(), static_cast<int>(delayedPackets[i].data.size()), sender);
+                delayedPackets.erase(delayedPackets.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    void sendNow(const char *data, int size, BatchSender &sender) {
+        if (sender.isFull()) {
+            sender.flush();
+        }
+        sender.add(data, size);
+    }
+
+    StreamDescriptor stream;
+    Impairments impairments;
+    std::mt19937 random;
+    std::uniform_real_distribution<double> uniform;
+    std::vector<char> pattern;
+    std::vector<char> packet;
+    std::vector<DelayedPacket> delayedPackets;
+    quint64 packetIndex;
+    quint64 dropped;
+    quint64 reordered;
+};
+
+int runGenerator(int fd, const sockaddr_in &target, const StreamDescriptor &stream, const Impairments &impairments,
+                 double rate, int batchSize, qint64 frames, quint32 seed) {
+    BatchSender sender(fd, target, batchSize);
+    StreamGenerator generator(stream, impairments, seed);
+
+    const double intervalNs = 1e9 / rate;
+    const qint64 start = monotonicNs();
+    qint64 nextReport = start + 1000000000;
+    quint64 reportedSent = 0;
+    quint64 packetNumber = 0;
+    quint16 frameId = 0;
+
+    out() << "Sending " << stream.width << "x" << stream.height << " frames at " << rate << " packets/s, "
+          << "batches of " << batchSize << "\n";
+    out().flush();
+
+    for (qint64 frame = 0; (frames <= 0 || frame < frames) && !stopRequested; ++frame, ++frameId) {
+        for (int n = 0; n < generator.packetsPerFrame() && !stopRequested; ++n) {
+            // A batch leaves when its first packet is due
+            if (sender.isEmpty()) {
+                sleepUntil(start + static_cast<qint64>(packetNumber * intervalNs));
+            }
+            generator.emitPacket(frameId, n, sender);
+            packetNumber++;
+            if (sender.isFull()) {
+                sender.flush();
+            }
+
+            const qint64 now = monotonicNs();
+            if (now >= nextReport) {
+                out() << "frame " << frameId << ": " << (sender.sentCount() - reportedSent) << " packets/s, "
+                      << generator.droppedCount() << " dropped, " << generator.reorderedCount() << " reordered, "
+                      << sender.failedCount() << " send failures" << "\n";
+                out().flush();
+                reportedSent = sender.sentCount();
+                nextReport += 1000000000;
+            }
+        }
+    }
+    generator.drain(sender);
+    sender.flush();
+
+    const double seconds = (monotonicNs() - start) / 1e9;
+    out() << "Sent " << sender.sentCount() << " packets in " << seconds << " s ("
+          << sender.sentCount() / qMax(seconds, 1e-9) << " packets/s, "
+          << double(sender.sentCount()) / qMax<quint64>(sender.syscallCount(), 1) << " per syscall), "
+          << generator.droppedCount() << " dropped, " << generator.reorderedCount() << " reordered, "
+          << sender.failedCount() << " send failures" << "\n";
+    return 0;
+}
+
+int runReplay(int fd, const sockaddr_in &target, const QStringList &inputs, double speed, int batchSize) {
+    PacketCaptureReader reader;
+    QStringList warnings;
+    reader.open(inputs, &warnings);
+    for (const QString &warning : warnings) {
+        out() << warning << "\n";
+    }
+    if (reader.segmentCount() == 0) {
+        out() << "Nothing to replay." << "\n";
+        return 1;
+    }
+
+    BatchSender sender(fd, target, batchSize);
+    const qint64 start = monotonicNs();
+    qint64 firstTimestamp = -1;
+    const qint64 batchWindowNs = 50000;  // Packets due within 50 us go out in one call
+
+    reader.forEachRecord([&](const PacketCaptureFormat::CaptureSegmentHeader &,
+                             const PacketCaptureFormat::CaptureRecordHeader &record, const uchar *payload) {
+        if (stopRequested) {
+            return false;
+        }
+        if (firstTimestamp < 0) {
+            firstTimestamp = record.timestampNs;
+        }
+
+        // Original spacing, scaled by speed
+        const qint64 due = start + static_cast<qint64>((record.timestampNs - firstTimestamp) / speed);
+        if (due - monotonicNs() > batchWindowNs) {
+            sender.flush();
+            sleepUntil(due);
+        }
+        if (sender.isFull()) {
+            sender.flush();
+        }
+        sender.add(reinterpret_cast<const char *>(payload), static_cast<int>(record.length));
+        return true;
+    });
+    sender.flush();
+
+    const double seconds = (monotonicNs() - start) / 1e9;
+    out() << "Replayed " << sender.sentCount() << " packets from " << reader.segmentCount() << " segments in "
+          << seconds << " s, " << sender.failedCount() << " send failures" << "\n";
+    return 0;
+}
+#endif
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("fpga_emulator");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Emulates the FPGA camera stream over UDP, or replays a packet capture.");
+    parser.addHelpOption();
+    QCommandLineOption targetOption("target", "Destination address.", "address", "127.0.0.1");
+    QCommandLineOption portOption("port", "Destination port.", "port", "8080");
+    QCommandLineOption configOption("config", "Stream config (udp_stream.ini) for geometry and header layout.", "file");
+    QCommandLineOption rateOption("rate", "Packets per second.", "pps", "24000");
+    QCommandLineOption batchOption("batch", "Packets per sendmmsg() call.", "count", "32");
+    QCommandLineOption framesOption("frames", "Frames to send, 0 for no limit.", "count", "0");
+    QCommandLineOption lossOption("loss", "Random packet loss probability.", "p", "0");
+    QCommandLineOption burstEveryOption("burst-every", "Drop a burst every N packets.", "N", "0");
+    QCommandLineOption burstLengthOption("burst-length", "Packets dropped per burst.", "count", "0");
+    QCommandLineOption reorderOption("reorder", "Probability of delaying a packet.", "p", "0");
+    QCommandLineOption reorderDistanceOption("reorder-distance", "Largest delay in packets.", "count", "8");
+    QCommandLineOption seedOption("seed", "Random seed for loss and reordering.", "seed", "1");
+    QCommandLineOption replayOption("replay", "Replay capture segments (directory or file) instead of generating.", "path");
+    QCommandLineOption speedOption("speed", "Replay speed factor.", "factor", "1");
+    parser.addOptions({targetOption, portOption, configOption, rateOption, batchOption, framesOption, lossOption,
+                       burstEveryOption, burstLengthOption, reorderOption, reorderDistanceOption, seedOption,
+                       replayOption, speedOption});
+    parser.process(app);
+
+#ifdef Q_OS_LINUX
+    QHostAddress address(parser.value(targetOption));
+    if (address.protocol() != QAbstractSocket::IPv4Protocol) {
+        out() << "Only IPv4 targets are supported." << "\n";
+        return 1;
+    }
+
+    sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(static_cast<quint16>(parser.value(portOption).toUInt()));
+    target.sin_addr.s_addr = htonl(address.toIPv4Address());
+
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        out() << "Failed to create socket: " << strerror(errno) << "\n";
+        return 1;
+    }
+    int sendBuffer = 8 * 1024 * 1024;
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    const int batchSize = qBound(1, parser.value(batchOption).toInt(), 1024);
+    int result;
+    if (parser.isSet(replayOption)) {
+        const double speed = qMax(parser.value(speedOption).toDouble(), 0.001);
+        result = runReplay(fd, target, QStringList() << parser.value(replayOption), speed, batchSize);
+    } else {
+        StreamDescriptor stream;
+        if (parser.isSet(configOption)) {
+            stream = loadStreamDescriptor(parser.value(configOption));
+        }
+
+        Impairments impairments;
+        impairments.loss = qBound(0.0, parser.value(lossOption).toDouble(), 1.0);
+        impairments.burstEvery = qMax(parser.value(burstEveryOption).toInt(), 0);
+        impairments.burstLength = qMax(parser.value(burstLengthOption).toInt(), 0);
+        impairments.reorder = qBound(0.0, parser.value(reorderOption).toDouble(), 1.0);
+        impairments.reorderDistance = qMax(parser.value(reorderDistanceOption).toInt(), 1);
+
+        const double rate = qMax(parser.value(rateOption).toDouble(), 1.0);
+        result = runGenerator(fd, target, stream, impairments, rate, batchSize,
+                              parser.value(framesOption).toLongLong(), parser.value(seedOption).toUInt());
+    }
+
+    ::close(fd);
+    return result;
+#else
+    out() << "fpga_emulator needs sendmmsg() and only runs on Linux." << "\n";
+    return 1;
+#endif
+}
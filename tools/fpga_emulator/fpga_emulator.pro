@@ -0,0 +1,20 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = fpga_emulator
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    fpga_emulator.cpp \
+    ../../PacketCaptureReader.cpp \
+    ../../StreamConfig.cpp
+
+HEADERS += \
+    ../../PacketCaptureFormat.h \
+    ../../PacketCaptureReader.h \
+    ../../PacketSlot.h \
+    ../../StreamConfig.h